@@ -0,0 +1,96 @@
+/*
+ * feedlist.cpp
+ *
+ * Benchmark of loading large feedfile.
+ *
+ * Project: Reader of news feed in format Atom & RSS with support of TLS
+ * Author: Matus Remen (xremen01@stud.fit.vutbr.cz)
+ * Date: 17.10.2026
+ */
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <unordered_set>
+#include <unistd.h>
+#include "../include/feedlist.hpp"
+#include "../include/url.hpp"
+
+
+// number of lines of feedfile, can be changed by first argument
+#define BENCH_LINES 2000000
+// every n-th line repeats an earlier url
+#define BENCH_REPEAT 10
+
+
+// feedfile with comments, empty lines and repeated urls
+void make_file(const char *path, size_t count){
+	std::ofstream file(path);
+	file << "# benchmark feedfile\n";
+	for (size_t i = 0; i < count; i++){
+		size_t n = i % BENCH_REPEAT ? i : i / 2;
+		file << "https://feeds" << n % 1000 << ".example.com/news/category-" << n << "/rss.xml?format=full\n";
+		if (i % 1000 == 0)
+			file << "\n# section " << i << "\n";
+	}
+}
+
+
+// feedfile read the way it was before, line by line into separate strings
+size_t load_getline(const char *path){
+	std::vector<std::string> lines;
+	std::ifstream file(path);
+	std::string str;
+	while (getline(file, str)){
+		if (str.empty() || str[0] == '#')
+			continue;
+		lines.push_back(str);
+	}
+
+	std::unordered_set<std::string> unique;
+	std::vector<std::string> urls;
+	for (std::string &line : lines)
+		if (FeedList::valid(line) && unique.insert(line).second)
+			urls.push_back(line);
+	return urls.size();
+}
+
+
+size_t load_mapped(const char *path, unsigned int threads){
+	FeedList list;
+	list.load(path, threads);
+	return list.urls().size();
+}
+
+
+int main(int argc, char **argv){
+	size_t count = argc > 1 ? strtoul(argv[1], nullptr, 10) : BENCH_LINES;
+	char path[] = "/tmp/feedlist_benchXXXXXX";
+	int fd = mkstemp(path);
+	close(fd);
+	make_file(path, count);
+
+	struct {
+		const char *name;
+		unsigned int threads;  // 0 for getline
+	} modes[] = {
+		{"getline", 0},
+		{"mmap-1", 1},
+		{"mmap-all", 0},
+	};
+
+	for (size_t i = 0; i < sizeof(modes) / sizeof(modes[0]); i++){
+		auto start = std::chrono::steady_clock::now();
+		size_t urls = i ? load_mapped(path, modes[i].threads) : load_getline(path);
+		std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+		std::cout << "mode " << modes[i].name << " lines " << count << " urls " << urls
+			<< " seconds " << time.count() << "\n";
+	}
+	unlink(path);
+
+	return 0;
+}
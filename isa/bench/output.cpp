@@ -0,0 +1,107 @@
+/*
+ * output.cpp
+ *
+ * Benchmark of number of write system calls needed to print feed messages.
+ *
+ * Project: Reader of news feed in format Atom & RSS with support of TLS
+ * Author: Matus Remen (xremen01@stud.fit.vutbr.cz)
+ * Date: 17.10.2026
+ */
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <fcntl.h>
+#include <unistd.h>
+#include <iostream>
+#include "../include/output.hpp"
+#include "../include/sink.hpp"
+#include "../include/writer.hpp"
+
+
+// number of printed messages, can be changed by first argument
+#define BENCH_ENTRIES 100000
+// messages per feed
+#define BENCH_FEED 100
+
+
+// messages with all optional fields
+std::vector<std::string> make_fields(size_t count){
+	std::vector<std::string> fields;
+	for (size_t i = 0; i < count; i++){
+		fields.push_back("Entry number " + std::to_string(i) + " of benchmark feed");
+		fields.push_back("2022-10-01T10:00:00Z");
+		fields.push_back("Author " + std::to_string(i % 97));
+		fields.push_back("https://news.example.com/entries/" + std::to_string(i));
+	}
+	return fields;
+}
+
+
+// print messages the way parser did before, every line ended by std::endl
+uint64_t print_endl(int fd, const std::vector<std::string> &fields, size_t count){
+	Writer writer(fd);
+	std::ostream out(&writer);
+	for (size_t i = 0; i < count; i++){
+		if (i % BENCH_FEED == 0)
+			out << (i ? "\n" : "") << "*** Feed " << i / BENCH_FEED << " ***" << std::endl;
+		else
+			out << "\n";
+		out << fields[4 * i] << std::endl;
+		out << "Aktualizace: " << fields[4 * i + 1] << std::endl;
+		out << "Autor: " << fields[4 * i + 2] << std::endl;
+		out << "URL: " << fields[4 * i + 3] << std::endl;
+	}
+	writer.flush();
+	return writer.writes();
+}
+
+
+// print messages through output with policy
+uint64_t print_output(int fd, const std::vector<std::string> &fields, size_t count, int policy){
+	Output output(fd, policy);
+	TextSink sink(_TS_OPT | _AU_OPT | _REF_OPT);
+	for (size_t i = 0; i < count; i++){
+		if (i % BENCH_FEED == 0){
+			if (i){
+				sink.separator(output.stream());
+				output.feed_done();
+			}
+			sink.feed(output.stream(), "", "Feed " + std::to_string(i / BENCH_FEED));
+		}
+		struct entry e = {"", "", fields[4 * i], fields[4 * i + 1], fields[4 * i + 2], fields[4 * i + 3]};
+		sink.message(output.stream(), e, i % BENCH_FEED);
+	}
+	output.feed_done();
+	output.flush();
+	return output.writes();
+}
+
+
+int main(int argc, char **argv){
+	size_t count = argc > 1 ? strtoul(argv[1], nullptr, 10) : BENCH_ENTRIES;
+	std::vector<std::string> fields = make_fields(count);
+	int fd = open("/dev/null", O_WRONLY);
+
+	struct {
+		const char *name;
+		int policy;  // 0 for printing with std::endl
+	} modes[] = {
+		{"endl", 0},
+		{"feed", FLUSH_FEED},
+		{"size", FLUSH_SIZE},
+		{"exit", FLUSH_EXIT},
+	};
+
+	for (auto &mode : modes){
+		auto start = std::chrono::steady_clock::now();
+		uint64_t writes = mode.policy ? print_output(fd, fields, count, mode.policy) : print_endl(fd, fields, count);
+		std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+		std::cout << "mode " << mode.name << " entries " << count << " writes " << writes
+			<< " seconds " << time.count() << "\n";
+	}
+	close(fd);
+
+	return 0;
+}
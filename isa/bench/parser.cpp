@@ -0,0 +1,148 @@
+/*
+ * parser.cpp
+ *
+ * Benchmark of extraction of messages from large parsed feed.
+ *
+ * Project: Reader of news feed in format Atom & RSS with support of TLS
+ * Author: Matus Remen (xremen01@stud.fit.vutbr.cz)
+ * Date: 17.10.2026
+ */
+
+#include <chrono>
+#include <algorithm>
+#include <string>
+#include <cstdlib>
+#include <fcntl.h>
+#include <unistd.h>
+#include <iostream>
+#include <libxml/parser.h>
+#include "../include/arena.hpp"
+#include "../include/output.hpp"
+#include "../include/parser.hpp"
+#include "../include/tags.hpp"
+
+
+// number of entries of archive feed (about 50 MB), can be changed by first argument
+#define BENCH_ENTRIES 120000
+// extraction is repeated, the fastest round is reported
+#define BENCH_ROUNDS 5
+
+
+// RSS archive feed with all fields in every item
+std::string make_feed(size_t count){
+	std::string feed = "<?xml version=\"1.0\"?><rss version=\"2.0\"><channel><title>Archive</title>"
+		"<link>https://news.example.com/</link><description>Benchmark archive</description>";
+	for (size_t i = 0; i < count; i++){
+		std::string n = std::to_string(i);
+		feed += "<item><title>Entry number " + n + " of benchmark archive feed</title>"
+			"<link>https://news.example.com/entries/" + n + "</link>"
+			"<description>Short description of entry " + n + " which is not printed at all</description>"
+			"<category>News</category><category>Benchmark</category>"
+			"<author>author" + std::to_string(i % 97) + "@example.com (Author)</author>"
+			"<guid>https://news.example.com/entries/" + n + "</guid>"
+			"<pubDate>Mon, 17 Oct 2026 10:00:00 GMT</pubDate></item>\n";
+	}
+	return feed + "</channel></rss>";
+}
+
+
+// fields read the way parser did before, chain of case insensitive compares for every child
+size_t extract_chain(xmlNodePtr root, Arena &arena){
+	size_t fields = 0;
+	for (xmlNodePtr node = root->children; node; node = node->next){
+		if (xmlStrcasecmp(node->name, (xmlChar *) "channel"))
+			continue;
+		for (xmlNodePtr item = node->children; item; item = item->next){
+			if (xmlStrcasecmp(item->name, (xmlChar *) "item"))
+				continue;
+			for (xmlNodePtr child = item->children; child; child = child->next){
+				if (!xmlStrcasecmp(child->name, (xmlChar *) "guid"))
+					fields += !arena.text(child).empty();
+				else if (!xmlStrcasecmp(child->name, (xmlChar *) "title"))
+					fields += !arena.text(child).empty();
+				else if (!xmlStrcasecmp(child->name, (xmlChar *) "pubDate"))
+					fields += !arena.text(child).empty();
+				else if (!xmlStrcasecmp(child->name, (xmlChar *) "author"))
+					fields += !arena.text(child).empty();
+				else if (!xmlStrcasecmp(child->name, (xmlChar *) "link"))
+					fields += !arena.text(child).empty();
+			}
+		}
+		break;
+	}
+	return fields;
+}
+
+
+// fields read through tag dispatch, names are recognized once per document
+size_t extract_tags(xmlNodePtr root, Arena &arena){
+	TagCache cache;
+	size_t fields = 0;
+	for (xmlNodePtr node = root->children; node; node = node->next){
+		if (cache.lookup(node->name) != TAG_CHANNEL)
+			continue;
+		for (xmlNodePtr item = node->children; item; item = item->next){
+			if (cache.lookup(item->name) != TAG_ITEM)
+				continue;
+			for (xmlNodePtr child = item->children; child; child = child->next){
+				switch (cache.lookup(child->name)){
+					case TAG_GUID: case TAG_TITLE: case TAG_PUBDATE: case TAG_AUTHOR: case TAG_LINK:
+						fields += !arena.text(child).empty();
+						break;
+					default:
+						break;
+				}
+			}
+		}
+		break;
+	}
+	return fields;
+}
+
+
+double seconds_since(std::chrono::steady_clock::time_point start){
+	std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+	return time.count();
+}
+
+
+int main(int argc, char **argv){
+	size_t count = argc > 1 ? strtoul(argv[1], nullptr, 10) : BENCH_ENTRIES;
+	std::string feed = make_feed(count);
+	int fd = open("/dev/null", O_WRONLY);
+
+	{
+		Output output(fd, FLUSH_EXIT);
+		auto start = std::chrono::steady_clock::now();
+		Parser parser(feed, true, true, true, output.stream());
+		double build = seconds_since(start);
+		start = std::chrono::steady_clock::now();
+		parser.parse_feed();
+		double extract = seconds_since(start);
+		std::cout << "parser bytes " << feed.size() << " entries " << count << " document " << build
+			<< " extraction " << extract << " seconds\n";
+	}
+
+	// extraction alone on the same document, without printing
+	xmlDocPtr document = xmlReadMemory(feed.data(), static_cast<int>(feed.size()), nullptr, nullptr, XML_PARSE_HUGE);
+	xmlNodePtr root = xmlDocGetRootElement(document);
+	// modes alternate so neither gets all the warm caches, best of rounds is printed
+	Arena arena;
+	double chain = 1e9, tags = 1e9;
+	size_t fields = 0;
+	for (int round = 0; round < BENCH_ROUNDS; round++){
+		auto start = std::chrono::steady_clock::now();
+		fields = extract_chain(root, arena);
+		chain = std::min(chain, seconds_since(start));
+		start = std::chrono::steady_clock::now();
+		fields = extract_tags(root, arena);
+		tags = std::min(tags, seconds_since(start));
+	}
+	std::cout << "mode chain fields " << fields << " seconds " << chain << "\n";
+	std::cout << "mode tags fields " << fields << " seconds " << tags << "\n";
+
+	xmlFreeDoc(document);
+	xmlCleanupParser();
+	close(fd);
+	return 0;
+}
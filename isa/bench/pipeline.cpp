@@ -0,0 +1,387 @@
+/*
+ * pipeline.cpp
+ *
+ * Benchmark of fetching and parsing feeds from local HTTP and HTTPS server.
+ *
+ * Project: Reader of news feed in format Atom & RSS with support of TLS
+ * Author: Matus Remen (xremen01@stud.fit.vutbr.cz)
+ * Date: 17.10.2026
+ */
+
+#include <map>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <csignal>
+#include <iostream>
+#include <algorithm>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <sys/wait.h>
+#include <sys/socket.h>
+#include <sys/resource.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <openssl/ssl.h>
+#include <openssl/pem.h>
+#include <openssl/x509v3.h>
+#include <libxml/parser.h>
+#include "../include/fetcher.hpp"
+#include "../include/output.hpp"
+#include "../include/parser.hpp"
+#include "../include/sessions.hpp"
+#include "../include/sink.hpp"
+
+
+// defaults of corpus and client, can be changed by options -n, -e, -s and -j
+#define BENCH_FEEDS 200
+#define BENCH_ENTRIES 50
+#define BENCH_TEXT 400
+#define BENCH_JOBS 4
+
+
+/*
+ * Output of one scenario is a single line of space separated key and value pairs:
+ *   scheme format feeds jobs entries bytes seconds bytes_per_s entries_per_s p50_ms p99_ms
+ *   connections handshakes resumed handshake_ms peak_rss_kb
+ * handshake_ms is average time of one TLS handshake (0 for http), peak_rss_kb is peak
+ * resident memory of process running the scenario (server runs in its own process).
+ */
+
+
+// options of benchmark
+struct setup {
+	size_t feeds = BENCH_FEEDS;      // number of feeds of each format
+	size_t entries = BENCH_ENTRIES;  // entries of each feed
+	size_t text = BENCH_TEXT;        // bytes of summary of each entry
+	unsigned int jobs = BENCH_JOBS;  // feeds fetched simultaneously
+};
+
+
+// feed number n in format "atom" or "rss"
+std::string make_feed(std::string format, size_t n, struct setup &setup){
+	std::string feed = std::to_string(n);
+	std::string summary(setup.text, 'x');
+	for (size_t i = 0; i < summary.size(); i += 8)
+		summary[i] = ' ';
+
+	std::string doc;
+	doc.reserve(setup.entries * (setup.text + 300) + 200);
+	if (format == "atom")
+		doc = "<?xml version=\"1.0\"?><feed xmlns=\"http://www.w3.org/2005/Atom\"><title>Feed " + feed + "</title>";
+	else
+		doc = "<?xml version=\"1.0\"?><rss version=\"2.0\"><channel><title>Feed " + feed + "</title>";
+
+	for (size_t i = 0; i < setup.entries; i++){
+		std::string entry = feed + "-" + std::to_string(i);
+		if (format == "atom")
+			doc += "<entry><title>Entry " + entry + "</title><id>urn:bench:" + entry + "</id>"
+				"<updated>2026-10-17T10:00:00Z</updated><author><name>Author " + entry + "</name></author>"
+				"<link href=\"https://bench.example.com/" + entry + "\"/><summary>" + summary + "</summary></entry>\n";
+		else
+			doc += "<item><title>Entry " + entry + "</title><guid>urn:bench:" + entry + "</guid>"
+				"<pubDate>Sat, 17 Oct 2026 10:00:00 GMT</pubDate><author>Author " + entry + "</author>"
+				"<link>https://bench.example.com/" + entry + "</link><description>" + summary + "</description></item>\n";
+	}
+	return doc + (format == "atom" ? "</feed>" : "</channel></rss>");
+}
+
+
+// self-signed certificate of stand-in server, written to file so that clients trust it
+bool make_certificate(EVP_PKEY *&key, X509 *&cert, std::string path){
+	key = EVP_PKEY_Q_keygen(nullptr, nullptr, "EC", "P-256");
+	cert = X509_new();
+	if (!key || !cert)
+		return false;
+
+	X509_set_version(cert, 2);
+	ASN1_INTEGER_set(X509_get_serialNumber(cert), 1);
+	X509_gmtime_adj(X509_getm_notBefore(cert), -3600);
+	X509_gmtime_adj(X509_getm_notAfter(cert), 86400);
+	X509_set_pubkey(cert, key);
+	X509_NAME *name = X509_get_subject_name(cert);
+	X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC, (const unsigned char *) "127.0.0.1", -1, -1, 0);
+	X509_set_issuer_name(cert, name);
+
+	X509V3_CTX ctx;
+	X509V3_set_ctx(&ctx, cert, cert, nullptr, nullptr, 0);
+	X509_EXTENSION *ext = X509V3_EXT_conf_nid(nullptr, &ctx, NID_basic_constraints, "critical,CA:TRUE");
+	if (!ext)
+		return false;
+	X509_add_ext(cert, ext, -1);
+	X509_EXTENSION_free(ext);
+	if (!X509_sign(cert, key, EVP_sha256()))
+		return false;
+
+	FILE *file = fopen(path.c_str(), "w");
+	if (!file)
+		return false;
+	bool ok = PEM_write_X509(file, cert);
+	return !fclose(file) && ok;
+}
+
+
+// listening socket on loopback with port chosen by system
+int listen_local(int &port){
+	int fd = socket(AF_INET, SOCK_STREAM, 0);
+	struct sockaddr_in addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	socklen_t length = sizeof(addr);
+	if (fd < 0 || bind(fd, (struct sockaddr *) &addr, sizeof(addr)) || listen(fd, SOMAXCONN)
+		|| getsockname(fd, (struct sockaddr *) &addr, &length))
+		return -1;
+	port = ntohs(addr.sin_port);
+	return fd;
+}
+
+
+// answer requests of one keep-alive connection, path is /<format>/<number>
+void serve_connection(int fd, SSL_CTX *tls, std::map<std::string, std::vector<std::string>> *corpora){
+	// response is written in several TLS records, Nagle's algorithm would delay the last one
+	int nodelay = 1;
+	setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+	SSL *ssl = nullptr;
+	if (tls){
+		ssl = SSL_new(tls);
+		SSL_set_fd(ssl, fd);
+		if (SSL_accept(ssl) <= 0){
+			SSL_free(ssl);
+			close(fd);
+			return;
+		}
+	}
+	auto receive = [&](char *data, int size){ return ssl ? SSL_read(ssl, data, size) : (int) read(fd, data, size); };
+	auto send = [&](const char *data, int size){ return ssl ? SSL_write(ssl, data, size) : (int) write(fd, data, size); };
+
+	std::string request;
+	char buffer[4096];
+	while (true){
+		size_t end;
+		while ((end = request.find("\r\n\r\n")) == std::string::npos){
+			int length = receive(buffer, sizeof(buffer));
+			if (length <= 0)
+				goto done;
+			request.append(buffer, length);
+		}
+
+		{
+			// GET /atom/12 HTTP/1.1
+			size_t start = request.find(' ') + 2;
+			size_t slash = request.find('/', start);
+			size_t stop = request.find(' ', start);
+			std::string format = request.substr(start, slash - start);
+			size_t n = strtoul(request.c_str() + slash + 1, nullptr, 10);
+			request.erase(0, end + 4);
+
+			auto corpus = corpora->find(format);
+			std::string head;
+			const std::string *body = nullptr;
+			if (slash < stop && corpus != corpora->end() && n < corpus->second.size()){
+				body = &corpus->second[n];
+				head = "HTTP/1.1 200 OK\r\nContent-Type: application/xml\r\nContent-Length: " + std::to_string(body->size())
+					+ "\r\nConnection: keep-alive\r\n\r\n";
+			}
+			else
+				head = "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\nConnection: keep-alive\r\n\r\n";
+
+			std::string response = head + (body ? *body : std::string());
+			for (size_t sent = 0; sent < response.size();){
+				int length = send(response.data() + sent, static_cast<int>(response.size() - sent));
+				if (length <= 0)
+					goto done;
+				sent += length;
+			}
+		}
+	}
+
+done:
+	if (ssl){
+		SSL_shutdown(ssl);
+		SSL_free(ssl);
+	}
+	close(fd);
+}
+
+
+// stand-in server, runs in child process until it is killed, ports are reported through pipe
+void run_server(int ready, EVP_PKEY *key, X509 *cert, struct setup &setup){
+	std::map<std::string, std::vector<std::string>> corpora;
+	for (std::string format : {"atom", "rss"})
+		for (size_t n = 0; n < setup.feeds; n++)
+			corpora[format].push_back(make_feed(format, n, setup));
+
+	SSL_CTX *tls = SSL_CTX_new(TLS_server_method());
+	if (!tls || SSL_CTX_use_certificate(tls, cert) != 1 || SSL_CTX_use_PrivateKey(tls, key) != 1)
+		_exit(1);
+
+	int ports[2];
+	struct pollfd listeners[2];
+	for (int i = 0; i < 2; i++){
+		listeners[i] = {listen_local(ports[i]), POLLIN, 0};
+		if (listeners[i].fd < 0)
+			_exit(1);
+	}
+	if (write(ready, ports, sizeof(ports)) != sizeof(ports))
+		_exit(1);
+	close(ready);
+
+	while (poll(listeners, 2, -1) > 0){
+		for (int i = 0; i < 2; i++){
+			if (!(listeners[i].revents & POLLIN))
+				continue;
+			int fd = accept(listeners[i].fd, nullptr, nullptr);
+			if (fd >= 0)
+				std::thread(serve_connection, fd, i ? tls : nullptr, &corpora).detach();
+		}
+	}
+	_exit(0);
+}
+
+
+/*
+ * Sink counting messages, titles are written so that output stage has some work as in real run.
+ */
+class CountSink : public Sink {
+public:
+	std::atomic<uint64_t> messages{0};
+
+	void message(std::ostream &out, const struct entry &e, int) override {
+		this->messages++;
+		out << e.title << '\n';
+	}
+};
+
+
+// fetch and parse all feeds of one format, prints result line
+void run_scenario(std::string scheme, int port, std::string format, std::string certfile, struct setup &setup){
+	std::vector<std::string> list;
+	for (size_t n = 0; n < setup.feeds; n++)
+		list.push_back(scheme + "://127.0.0.1:" + std::to_string(port) + "/" + format + "/" + std::to_string(n));
+	std::vector<std::string_view> urls(list.begin(), list.end());
+
+	// all feeds are on one host, it must not limit the number of jobs
+	SessionCache sessions;
+	Fetcher fetcher = Fetcher(certfile, "", setup.jobs);
+	struct host_limits limits;
+	limits.connections = 0;
+	fetcher.set_host_limits(limits);
+	fetcher.set_session_cache(&sessions);
+
+	CountSink sink;
+	int devnull = open("/dev/null", O_WRONLY);
+	Output output = Output(devnull);
+	std::vector<double> latency(urls.size());
+	std::atomic<uint64_t> bytes{0};
+
+	// latency of feed is time from start of its request until it is parsed
+	auto start = std::chrono::steady_clock::now();
+	fetcher.stream(urls, [&](size_t idx, Client &client, std::ostream &out){
+		auto begin = std::chrono::steady_clock::now();
+		Buffer data;
+		std::string_view body = client.request(list[idx], data);
+		bytes += body.size();
+		if (!body.empty()){
+			Parser parser = Parser(body, false, false, false, out);
+			parser.set_sink(&sink, list[idx]);
+			parser.parse_feed();
+		}
+		latency[idx] = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+	}, output);
+	output.flush();
+	std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+	close(devnull);
+
+	std::sort(latency.begin(), latency.end());
+	double p50 = latency.empty() ? 0 : latency[latency.size() / 2];
+	double p99 = latency.empty() ? 0 : latency[std::min(latency.size() - 1, latency.size() * 99 / 100)];
+	struct client_stats stats = fetcher.get_client_stats();
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+	long peak = usage.ru_maxrss / 1024;
+#else
+	long peak = usage.ru_maxrss;
+#endif
+
+	std::cout << "scheme " << scheme << " format " << format << " feeds " << setup.feeds << " jobs " << setup.jobs
+		<< " entries " << sink.messages << " bytes " << bytes << " seconds " << time.count()
+		<< " bytes_per_s " << (uint64_t) (bytes / time.count()) << " entries_per_s " << (uint64_t) (sink.messages / time.count())
+		<< " p50_ms " << p50 << " p99_ms " << p99 << " connections " << stats.connections
+		<< " handshakes " << stats.handshakes << " resumed " << stats.resumed
+		<< " handshake_ms " << (stats.handshakes ? stats.handshake_us / 1000.0 / stats.handshakes : 0)
+		<< " peak_rss_kb " << peak << std::endl;
+}
+
+
+int main(int argc, char **argv){
+	struct setup setup;
+	int opt;
+	while ((opt = getopt(argc, argv, "n:e:s:j:")) != -1){
+		long value = strtol(optarg, nullptr, 10);
+		if (value < 1){
+			std::cerr << "Usage: pipeline [-n <feeds>] [-e <entries>] [-s <text bytes>] [-j <jobs>]" << std::endl;
+			return 1;
+		}
+		if (opt == 'n') setup.feeds = value;
+		else if (opt == 'e') setup.entries = value;
+		else if (opt == 's') setup.text = value;
+		else if (opt == 'j') setup.jobs = value;
+		else return 1;
+	}
+
+	char certfile[] = "/tmp/pipeline_benchXXXXXX";
+	close(mkstemp(certfile));
+	EVP_PKEY *key = nullptr;
+	X509 *cert = nullptr;
+	if (!make_certificate(key, cert, certfile)){
+		std::cerr << "Can't create certificate of server." << std::endl;
+		unlink(certfile);
+		return 1;
+	}
+
+	// server and each scenario run in separate processes, so memory of one does not count to others
+	int ready[2];
+	if (pipe(ready))
+		return 1;
+	pid_t server = fork();
+	if (server == 0){
+		close(ready[0]);
+		run_server(ready[1], key, cert, setup);
+	}
+	close(ready[1]);
+	int ports[2];
+	bool started = read(ready[0], ports, sizeof(ports)) == sizeof(ports);
+	close(ready[0]);
+
+	if (started){
+		for (std::string scheme : {"http", "https"})
+			for (std::string format : {"atom", "rss"}){
+				pid_t scenario = fork();
+				if (scenario == 0){
+					xmlInitParser();
+					run_scenario(scheme, ports[scheme == "https"], format, certfile, setup);
+					_exit(0);
+				}
+				waitpid(scenario, nullptr, 0);
+			}
+	}
+	else
+		std::cerr << "Can't start server." << std::endl;
+
+	kill(server, SIGKILL);
+	waitpid(server, nullptr, 0);
+	unlink(certfile);
+	X509_free(cert);
+	EVP_PKEY_free(key);
+	return started ? 0 : 1;
+}
@@ -0,0 +1,73 @@
+/*
+ * url.cpp
+ *
+ * Micro-benchmark of url scanner against regular expression it replaced.
+ *
+ * Project: Reader of news feed in format Atom & RSS with support of TLS
+ * Author: Matus Remen (xremen01@stud.fit.vutbr.cz)
+ * Date: 17.10.2026
+ */
+
+#include <chrono>
+#include <regex>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <iostream>
+#include "../include/url.hpp"
+
+
+// number of urls in corpus, can be changed by first argument
+#define BENCH_URLS 1000000
+
+
+// build corpus of urls with various lengths and parts, every 16th one is invalid
+std::vector<std::string> make_corpus(size_t count){
+	const char *hosts[] = {"www.example.com", "feeds.news.example.org", "blog.example.net:8080",
+		"[2001:db8::17]", "user@planet.example.com", "127.0.0.1:8765"};
+	const char *paths[] = {"", "/", "/feed", "/rss/all.xml?lang=en", "/atom/feed.xml#latest",
+		"/category/technology/linux/feed/atom/?page=2&limit=50"};
+	std::vector<std::string> corpus;
+	corpus.reserve(count);
+
+	for (size_t i = 0; i < count; i++){
+		std::string url = (i % 3) ? "https://" : "http://";
+		url += hosts[i % 6];
+		url += paths[(i / 6) % 6];
+		if (i % 16 == 15)
+			url = "htp:/" + url.substr(8);
+		corpus.push_back(url);
+	}
+	return corpus;
+}
+
+
+int main(int argc, char **argv){
+	size_t count = argc > 1 ? strtoul(argv[1], nullptr, 10) : BENCH_URLS;
+	std::vector<std::string> corpus = make_corpus(count);
+
+	// expression used by Client::parse_url before the scanner
+	static std::regex re_url(R"(^(https?)://([^/?#:]+)(:[0-9]+)?(.*)$)");
+	std::smatch match;
+	size_t valid_regex = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (const std::string &url : corpus)
+		valid_regex += std::regex_match(url, match, re_url);
+	std::chrono::duration<double> regex_time = std::chrono::steady_clock::now() - start;
+
+	struct url_view parts;
+	size_t valid_scan = 0;
+	start = std::chrono::steady_clock::now();
+	for (const std::string &url : corpus)
+		valid_scan += scan_url(url, parts);
+	std::chrono::duration<double> scan_time = std::chrono::steady_clock::now() - start;
+
+	std::cout << "urls " << count << "\n"
+		<< "regex_valid " << valid_regex << " regex_s " << regex_time.count()
+		<< " regex_ns_per_url " << regex_time.count() * 1e9 / count << "\n"
+		<< "scan_valid " << valid_scan << " scan_s " << scan_time.count()
+		<< " scan_ns_per_url " << scan_time.count() * 1e9 / count << "\n"
+		<< "speedup " << regex_time.count() / scan_time.count() << std::endl;
+
+	return 0;
+}
@@ -0,0 +1,64 @@
+/*
+ * arena.hpp
+ *
+ * Arena holding text extracted from parsed feed document.
+ *
+ * Project: Reader of news feed in format Atom & RSS with support of TLS
+ * Author: Matus Remen (xremen01@stud.fit.vutbr.cz)
+ * Date: 17.10.2026
+ */
+
+#ifndef _ARENA_HPP
+#define _ARENA_HPP
+
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <string_view>
+#include <libxml/tree.h>
+
+
+// size of one arena block, longer strings get block of their own
+#define ARENA_BLOCK 4096
+
+
+/*
+ * Text of elements and attributes of one feed document.
+ * Text stored in single text node is borrowed straight from the document, text spread over
+ * more nodes is copied into arena blocks. Nothing is freed separately, all blocks are released
+ * together when feed is done, views are valid as long as both arena and document exist.
+ */
+class Arena {
+private:
+	std::vector<std::unique_ptr<char[]>> blocks;
+	char *top;      // free space in last block
+	size_t left;    // bytes left in last block
+	size_t total;   // bytes allocated in all blocks
+
+	// reserve size bytes in arena
+	char *allocate(size_t size);
+	// length of text of nodes in list and their descendants
+	static size_t measure(xmlNodePtr node);
+	// copy text of nodes in list and their descendants to dst, returns end of copied text
+	static char *fill(xmlNodePtr node, char *dst);
+
+public:
+	Arena();
+
+	Arena(const Arena &) = delete;
+	Arena &operator=(const Arena &) = delete;
+
+	// copy data into arena
+	std::string_view store(std::string_view data);
+	// text content of node, same as xmlNodeGetContent() without allocation per call
+	std::string_view text(xmlNodePtr node);
+	// value of attribute of node, empty if node has no such attribute
+	std::string_view prop(xmlNodePtr node, const char *name);
+
+	// release all blocks, previously returned views become invalid
+	void clear();
+	// bytes allocated by arena
+	size_t allocated();
+};
+
+#endif
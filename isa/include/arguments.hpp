@@ -13,6 +13,9 @@
 
 #include <string>
 #include <getopt.h>
+#include "output.hpp"
+#include "scheduler.hpp"
+#include "timeouts.hpp"
 
 
 /**
@@ -32,27 +35,68 @@ private:
 	std::string _cert_file;  // certificate file
 	std::string _certaddr;   // file for server certificate validation
 
+	std::string _session_file;  // file where TLS sessions are kept between runs
+	std::string _cache_dir;     // directory with cached feeds for conditional requests
+	std::string _seen_file;     // store of entries printed by previous runs
+	std::string _poll_file;     // update history of feeds, only due feeds are fetched
+	std::string _daemon_socket; // socket of daemon mode, empty for single run
+	std::string _format = "text";  // output format
+	int _flush_policy = FLUSH_FEED;          // when output is written
+	size_t _flush_threshold = FLUSH_THRESHOLD;  // buffer size of size policy
+
+	unsigned int _jobs = 1;  // maximum number of feeds fetched simultaneously
+	unsigned int _parsers = 1;  // number of threads parsing fetched feeds
+	struct timeouts _timeouts;  // time limits of each request
+	struct host_limits _host_limits;  // limits of requests to one host
+
 	bool _opt_timestamp = false;  // option to print timestamps for feed messages
 	bool _opt_author = false;     // option to print authors of messages
 	bool _opt_ref = false;        // option to print references for feed messages
 	bool _opt_help = false;       // option to print program usage
+	bool _opt_stream = false;     // option to parse feeds while they are received
+	bool _opt_stats = false;      // option to print pipeline statistics
 
 	const std::string USAGE =
-		"Usage: feedreader <URL | -f <feedfile>> [-c <certfile>] [-C <certaddr>] [-T] [-a] [-u]\n"
+		"Usage: feedreader <URL | -f <feedfile>> [-c <certfile>] [-C <certaddr>] [-T] [-a] [-u] [-j <jobs>] [-s <sessionfile>] [-S] [-d <cachedir>] [-t <timeouts>] [-H <hostlimits>] [-n <seenfile>] [-P <pollfile>] [-D <socket>] [-p <parsers>] [--stats] [-o <format>] [-F <flush>]\n"
 		"\n"
 		"Args:\n"
-		"    URL           - target feed URL\n"
-		"    -f <feedfile> - path to file with feed URLs\n"
+		"    URL              - target feed URL\n"
+		"    -f <feedfile>    - path to file with feed URLs\n"
 		"\n"
-		"    -c <certfile> - path to file with certificates\n"
-		"    -C <certaddr> - directory with certificates\n"
-		"    -T            - print timestamps\n"
-		"    -a            - print authors\n"
-		"    -u            - print associated URL\n";
+		"    -c <certfile>    - path to file with certificates\n"
+		"    -C <certaddr>    - directory with certificates\n"
+		"    -T               - print timestamps\n"
+		"    -a               - print authors\n"
+		"    -u               - print associated URL\n"
+		"    -j <jobs>        - number of feeds fetched simultaneously (default 1)\n"
+		"    -s <sessionfile> - file for keeping TLS sessions between runs\n"
+		"    -S               - parse feeds while they are received, print messages as soon as they are complete\n"
+		"    -d <cachedir>    - directory for caching feeds, unchanged feeds are not downloaded again\n"
+		"    -t <timeouts>    - time limits of request in seconds as connect,handshake,first-byte,total\n"
+		"                       (default 10,10,30,300), empty field keeps default, 0 means no limit\n"
+		"    -H <hostlimits>  - limits of requests to one host as connections,rate,burst (default 4,0,4),\n"
+		"                       rate is in requests per second, empty field keeps default, 0 means no limit\n"
+		"    -n <seenfile>    - print only entries not printed before, they are remembered in seenfile\n"
+		"                       (--new-only <seenfile>)\n"
+		"    -P <pollfile>    - fetch only feeds due by update history kept in pollfile, feeds updating\n"
+		"                       rarely are polled less often (--poll <pollfile>)\n"
+		"    -D <socket>      - keep running, poll feeds when they are due and answer queries for their\n"
+		"                       entries on Unix socket (--daemon <socket>), request lines are FEEDS,\n"
+		"                       ENTRIES <url>, LATEST [<count>] and STATUS, entries are sent in output format\n"
+		"    -p <parsers>     - number of threads parsing fetched feeds (default 1)\n"
+		"    --stats          - print queue depths and throughput of fetch, parse and output stages\n"
+		"    -o <format>      - output format: text (default), jsonl, csv or binary, structured formats\n"
+		"                       contain all fields of messages, -T, -a and -u apply to text only\n"
+		"    -F <flush>       - when output is written: feed (after each feed, default), exit (at exit)\n"
+		"                       or number of bytes collected before writing, at most 64 MiB (--flush <flush>)\n";
 
 
 	// check if required arguments were passed to program
 	bool check_required();
+	// parse comma separated list of time limits in seconds
+	bool parse_timeouts(std::string list);
+	// parse comma separated list of limits of one host
+	bool parse_host_limits(std::string list);
 	// method for parsing program arguments, sets object attributes
 	bool parse_arguments(int argc, char **argv);
 
@@ -73,6 +117,29 @@ public:
 	std::string get_cert_file();
 	// return certificate validation file
 	std::string get_certaddr();
+	// return file with stored TLS sessions
+	std::string get_session_file();
+	// return directory of feed cache
+	std::string get_cache_dir();
+	// return file with entries printed by previous runs
+	std::string get_seen_file();
+	// return file with update history of feeds
+	std::string get_poll_file();
+	// return socket of daemon mode
+	std::string get_daemon_socket();
+	// return maximum number of simultaneous requests
+	unsigned int get_jobs();
+	// return output format
+	std::string get_format();
+	// return output flush policy and threshold of size policy
+	int get_flush_policy();
+	size_t get_flush_threshold();
+	// return number of parser threads
+	unsigned int get_parsers();
+	// return time limits of requests
+	struct timeouts get_timeouts();
+	// return limits of requests to one host
+	struct host_limits get_host_limits();
 
 	// check valid flag
 	bool ok();
@@ -82,6 +149,14 @@ public:
 	bool au();
 	// check reference flag
 	bool ref();
+	// check streaming flag
+	bool stream();
+	// check statistics flag
+	bool stats();
+	// check new entries only flag
+	bool new_only();
+	// check daemon mode flag
+	bool daemon();
 };
 
 #endif
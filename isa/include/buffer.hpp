@@ -0,0 +1,59 @@
+/*
+ * buffer.hpp
+ *
+ * Growable byte buffer for receiving responses without intermediate copies.
+ *
+ * Project: Reader of news feed in format Atom & RSS with support of TLS
+ * Author: Matus Remen (xremen01@stud.fit.vutbr.cz)
+ * Date: 17.10.2026
+ */
+
+#ifndef _BUFFER_HPP
+#define _BUFFER_HPP
+
+#include <cstddef>
+#include <string_view>
+
+
+/*
+ * Contiguous byte buffer, data are written directly to its free space at the end
+ * and committed afterwards. Contents may contain any bytes including NUL.
+ * Views returned by the buffer are valid until it grows or is cleared.
+ */
+class Buffer {
+private:
+	char *bytes;      // allocated memory
+	size_t capacity;  // size of allocated memory
+	size_t length;    // number of used bytes
+
+public:
+	Buffer();
+	Buffer(Buffer &&other) noexcept;
+	Buffer &operator=(Buffer &&other) noexcept;
+	Buffer(const Buffer &) = delete;
+	Buffer &operator=(const Buffer &) = delete;
+	~Buffer();
+
+	// make sure buffer can hold at least size bytes without reallocation
+	void reserve(size_t size);
+	// return pointer to at least min free bytes at the end of buffer
+	char *space(size_t min);
+	// mark n bytes written to space at the end of buffer as used
+	void commit(size_t n);
+	// drop contents, allocated memory is kept for next use
+	void clear();
+	// drop used bytes behind size
+	void truncate(size_t size);
+	// remove n bytes starting at pos, following bytes are moved forward
+	void erase(size_t pos, size_t n);
+
+	// return pointer to contents
+	const char *data() const;
+	char *data();
+	// return number of used bytes
+	size_t size() const;
+	// return view of contents starting at pos, at most n bytes
+	std::string_view view(size_t pos = 0, size_t n = std::string_view::npos) const;
+};
+
+#endif
@@ -0,0 +1,64 @@
+/*
+ * cache.hpp
+ *
+ * On-disk cache of feed responses for conditional requests (ETag / Last-Modified).
+ *
+ * Project: Reader of news feed in format Atom & RSS with support of TLS
+ * Author: Matus Remen (xremen01@stud.fit.vutbr.cz)
+ * Date: 17.10.2026
+ */
+
+#ifndef _CACHE_HPP
+#define _CACHE_HPP
+
+#include <ctime>
+#include <cstdio>
+#include <string>
+#include <functional>
+#include <string_view>
+#include "buffer.hpp"
+
+
+// validators of cached response, sent back to server in conditional request
+struct validators {
+	std::string etag;
+	std::string last_modified;
+};
+
+
+/*
+ * Cache keeps last successful response body of every url together with its validators
+ * in a directory, one file per url. Entries are written to temporary file first and renamed
+ * when complete, so cache can be used by multiple clients (threads, processes) at once.
+ */
+class HttpCache {
+private:
+	std::string dir;  // cache directory
+
+	// return path of cache file for url
+	std::string path(std::string url);
+	// open cache file of url and read its header, returns nullptr if there is no valid entry
+	FILE *open_entry(std::string url, struct validators &v);
+
+public:
+	HttpCache(std::string dir);
+	~HttpCache();
+
+	// create cache directory if it does not exist yet
+	bool init();
+
+	// get validators of cached response for url, returns false if url is not cached
+	bool lookup(std::string url, struct validators &v);
+	// time when cached response of url was stored, that is when feed last changed, 0 if url is not cached
+	time_t changed(std::string url);
+	// read cached body of url into buffer, if consumer is given body is passed to it in pieces
+	// and buffer holds only the last piece
+	bool read(std::string url, Buffer &data, std::function<void(std::string_view)> consumer = nullptr);
+
+	// start storing new response of url, returns handle for appending body, nullptr on failure
+	FILE *begin(std::string url, struct validators &v, std::string &tmp_path);
+	// finish storing, complete entry replaces previous one, incomplete one is thrown away
+	void end(std::string url, FILE *entry, std::string &tmp_path, bool complete);
+};
+
+#endif
@@ -12,22 +12,50 @@
 #define _CLIENT_HPP
 
 #include <map>
-#include <regex>
+#include <ctime>
+#include <chrono>
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <iostream>
+#include <functional>
 #include <openssl/bio.h>
 #include <openssl/ssl.h>
 #include <openssl/err.h>
+#include "cache.hpp"
+#include "buffer.hpp"
+#include "decoder.hpp"
+#include "http.hpp"
+#include "resolver.hpp"
+#include "sessions.hpp"
+#include "timeouts.hpp"
+#include "url.hpp"
 
 
 // size of buffer where response from server is read
 #define BUFFER_SIZE 8192
+// most bytes reserved for body before it arrives, announced length is not trusted beyond it
+#define RESERVE_LIMIT (8 << 20)
+// number of seconds after which idle connection is not reused anymore
+#define KEEPALIVE_TIMEOUT 5
+// maximum number of idle connections kept open by client
+#define POOL_SIZE 32
+
+// counters of client since it was created
+struct client_stats {
+	uint64_t requests = 0;
+	uint64_t connections = 0;   // new connections, reused ones are not counted
+	uint64_t handshakes = 0;    // TLS handshakes including resumed ones
+	uint64_t resumed = 0;       // handshakes which resumed previous session
+	uint64_t handshake_us = 0;  // time spent in TLS handshakes
+};
 
 // url structure, holds parsed url properties
 struct url {
 	bool valid;
 	std::string protocol;
-	std::string authority;
+	std::string host;       // host name or address without brackets of IPv6 literal
+	std::string authority;  // host:port
 	std::string path;
 	std::string port;
 };
@@ -43,28 +71,111 @@ private:
 	std::string certaddr;
 
 	BIO *bio;      // Basic Input Output API, used for sending and receiving messages via sockets - network
-	SSL_CTX *ctx;  // SSL object configurator, factory
+	SSL_CTX *ctx;  // SSL object configurator, factory - lives as long as the client, holds trust store
+	SessionCache *sessions;  // TLS sessions for resumption, not owned by client, may be shared
+	Resolver own_resolver;   // resolver used when no shared one is set
+	Resolver *resolver;      // host name lookups, not owned by client, may be shared
+	HttpCache *cache;        // cache of responses for conditional requests, not owned by client
+
+	std::string cache_url;   // url of response being received
+	FILE *cache_entry;       // cache entry of response being received, nullptr if it is not cached
+	std::string cache_tmp;   // temporary file of cache entry
+
+	// idle keep-alive connection
+	struct connection {
+		BIO *bio;
+		time_t last_used;
+	};
+	std::map<std::string, struct connection> pool;  // idle connections by protocol and authority
+
+	struct timeouts timeouts;  // time limits of requests
+	std::chrono::steady_clock::time_point started;   // start of current request
+	std::chrono::steady_clock::time_point deadline;  // deadline of current phase of request
+	const char *phase;  // name of current phase of request, for reporting
+	struct client_stats stats;
+	bool expired;       // deadline of current phase expired
+
+	std::function<void(std::string_view)> consumer;  // receiver of body pieces in streaming mode
+	bool streaming;    // body of current response is passed to consumer while it arrives
+	size_t delivered;  // number of body bytes passed to consumer during current request
+	bool completed;    // last request received whole successful response
+
+	HttpParser parser; // framing of response being received
+	Decoder decoder;   // decompression of body by content coding
+	Buffer decoded;    // output of decoder
 
 	std::map<std::string, std::string> PORT_MAP;  // mapping of protocols to ports
 
-	// clean resources
+	// clean per-request resources
 	void cleanup();
 
+	// create SSL_CTX and load trust store, done once per client or after certificate setup change
+	bool init_context();
+
 	// method for parsing url string into url structure for easier manipulation
-	struct url parse_url(std::string url);
-	// method for setting up SSL_CTX by loading certificates based on protocol and user setup
-	bool verify_certificate(std::string protocol, std::string authority);
+	struct url parse_url(std::string_view url);
+	// method for wrapping connected socket into BIO, TLS layer is added for https using SSL_CTX
+	// with certificates loaded based on user setup
+	bool verify_certificate(std::string protocol, int fd);
 	// socket and SSL setup
 	bool socket_init(struct url _url);
+	// remember TLS session of current connection for later resumption
+	void store_session(std::string authority);
 	
-	// method for parsing server response, for successful responses (code 200) returns it's body
-	std::string get_response_body(std::string response);
+	// take idle connection to host from pool as current one, returns false if there is none
+	bool take_connection(std::string key);
+	// return current connection to pool for later requests
+	void keep_connection(std::string key);
+	// close connections idle for too long
+	void evict_idle();
+
+	// start next phase of request limited by timeout (ms), whole request is still limited by total timeout
+	void start_phase(const char *phase, int timeout);
+	// milliseconds left until deadline of current phase, -1 if there is no deadline
+	int remaining();
+	// wait until current connection is ready for operation BIO asked to retry, false if deadline expired
+	bool wait_io();
+	// perform TLS handshake on current connection
+	bool handshake();
+	// write whole request to current connection
+	bool send_request(std::string &http_request);
+	// read available data from current connection directly into buffer, returns 0 on EOF, -1 on error
+	int read_some(Buffer &data);
+	// prepare streaming, caching and decompression once response head is known
+	bool start_body(struct response &resp);
+	// in streaming mode pass (decompressed) body decoded so far to consumer and drop it from buffer
+	bool deliver(Buffer &data);
+	// read one response from current connection into buffer, compressed body is decompressed
+	bool read_response(Buffer &data, struct response &resp);
+	// method for checking parsed server response, for successful responses (code 2xx) returns view of it's body
+	std::string_view get_response_body(struct response &resp);
 public:
 	Client(std::string certfile, std::string certaddr);
 	~Client();
 
-	// setup connection to server and send request, returns response body
-	std::string request(std::string url);
+	// change certificate file/directory, trust store is rebuilt only if they differ from current ones
+	void set_certificates(std::string certfile, std::string certaddr);
+	// use cache for TLS session resumption, nullptr disables resumption
+	void set_session_cache(SessionCache *sessions);
+	// set time limits of requests
+	void set_timeouts(struct timeouts timeouts);
+	// use shared resolver for host name lookups, nullptr returns to client's own one
+	void set_resolver(Resolver *resolver);
+	// use cache of responses, feeds are then requested conditionally, nullptr disables caching
+	void set_http_cache(HttpCache *cache);
+
+	// return counters of requests, connections and handshakes
+	struct client_stats get_stats();
+
+	// setup connection to server and send request, response is received into data buffer,
+	// returns view of response body inside the buffer (empty on failure), request fails
+	// once any of deadlines expires
+	// if consumer is given, body of successful response is passed to it in pieces as it arrives
+	// instead, buffer then holds only yet unprocessed data and empty view is returned
+	std::string_view request(std::string url, Buffer &data, std::function<void(std::string_view)> consumer = nullptr);
+	// true if last request received whole successful response, tells failure apart from
+	// empty body and from streamed response
+	bool request_completed();
 };
 
 #endif
@@ -0,0 +1,31 @@
+/*
+ * connect.hpp
+ *
+ * Connecting to hosts with multiple addresses by Happy Eyeballs algorithm (RFC 8305).
+ *
+ * Project: Reader of news feed in format Atom & RSS with support of TLS
+ * Author: Matus Remen (xremen01@stud.fit.vutbr.cz)
+ * Date: 17.10.2026
+ */
+
+#ifndef _CONNECT_HPP
+#define _CONNECT_HPP
+
+#include <vector>
+#include "resolver.hpp"
+
+
+// milliseconds to wait for connection attempt before next address is tried in parallel
+#define CONNECT_ATTEMPT_DELAY 250
+
+
+// order addresses for connection attempts, address families alternate starting with the preferred one
+std::vector<struct address> interleave_addresses(const std::vector<struct address> &addresses);
+
+// connect to port of any of addresses, attempts are started one after another with a short delay
+// and run in parallel, first established connection wins and others are closed,
+// returns connected socket in non-blocking mode or -1 if no attempt succeeded within timeout (ms),
+// negative timeout means no limit
+int happy_connect(const std::vector<struct address> &addresses, unsigned short port, int timeout);
+
+#endif
@@ -0,0 +1,96 @@
+/*
+ * daemon.hpp
+ *
+ * Long running mode polling feeds and answering queries on Unix socket.
+ *
+ * Project: Reader of news feed in format Atom & RSS with support of TLS
+ * Author: Matus Remen (xremen01@stud.fit.vutbr.cz)
+ * Date: 17.10.2026
+ */
+
+#ifndef _DAEMON_HPP
+#define _DAEMON_HPP
+
+#include <ctime>
+#include <chrono>
+#include <atomic>
+#include <string>
+#include <vector>
+#include <ostream>
+#include <csignal>
+#include <string_view>
+#include "fetcher.hpp"
+#include "index.hpp"
+#include "poll.hpp"
+#include "sink.hpp"
+
+
+// shortest time in seconds between starts of two polling rounds
+#define DAEMON_ROUND 60
+// number of entries returned by LATEST without count
+#define DAEMON_LATEST 20
+// longest request line in bytes
+#define DAEMON_REQUEST 4096
+// time in milliseconds given to client to send whole request and to read whole response
+#define DAEMON_TIMEOUT 1000
+// time in milliseconds after which waiting loops check for termination
+#define DAEMON_TICK 200
+
+
+/*
+ * Daemon keeps fetcher (and so TLS contexts, sessions and connections of its clients)
+ * alive between polling rounds. Each round fetches feeds which are due by update history
+ * and puts their entries into in-memory index. Index is queried over Unix socket
+ * by separate thread, so queries are answered also while a round is running.
+ *
+ * Protocol: client sends one request line and reads response until connection is closed.
+ *   FEEDS            - one line per feed: url, time of last update, number of entries, title
+ *   ENTRIES <url>    - entries of feed in output format
+ *   LATEST [<count>] - newest entries of all feeds in output format
+ *   STATUS           - number of rounds, feeds and entries
+ * Error response is a single line starting with "ERROR".
+ */
+class Daemon {
+private:
+	Fetcher &fetcher;
+	PollStore &poll;
+	Sink &sink;               // format of entries in responses
+	std::string socket_path;
+	std::string poll_file;    // update history is saved there after each round, empty keeps it in memory
+	EntryIndex index;
+	int listener;             // listening socket
+	std::atomic<unsigned long> rounds;  // number of finished polling rounds
+
+	static volatile sig_atomic_t stopping;  // termination was requested by signal
+
+	static void on_signal(int);
+	// create listening socket, stale socket file of previous daemon is replaced,
+	// fails if socket belongs to daemon which is still running
+	bool listen_socket();
+	// server thread body, answers connections until termination
+	void serve();
+	// wait until client socket is ready for events, false once deadline passed
+	static bool wait_client(int fd, short events, std::chrono::steady_clock::time_point deadline);
+	// read request from connected client and send response
+	void answer(int fd);
+	// fetch feeds which are due and put them into index
+	void round(const std::vector<std::string_view> &urls);
+
+public:
+	Daemon(Fetcher &fetcher, PollStore &poll, Sink &sink, std::string socket_path);
+	~Daemon();
+
+	// save update history to file after each round
+	void set_poll_file(std::string path);
+
+	// poll feeds and answer queries until SIGINT or SIGTERM, false if socket can't be created
+	bool run(const std::vector<std::string_view> &urls);
+	// write response to one request line
+	void handle(std::string_view request, std::ostream &out);
+	// put parsed feed into index, false if feed could not be read
+	bool update(std::string url, std::string_view body);
+	// time when next round should start, round before started at started
+	time_t next_round(const std::vector<std::string_view> &urls, time_t started);
+};
+
+#endif
@@ -0,0 +1,83 @@
+/*
+ * decoder.hpp
+ *
+ * Streaming decompression of response bodies (Content-Encoding gzip, deflate, br).
+ *
+ * Project: Reader of news feed in format Atom & RSS with support of TLS
+ * Author: Matus Remen (xremen01@stud.fit.vutbr.cz)
+ * Date: 17.10.2026
+ */
+
+#ifndef _DECODER_HPP
+#define _DECODER_HPP
+
+#include <string>
+#include <string_view>
+#include <zlib.h>
+#ifdef HAVE_BROTLI
+#include <brotli/decode.h>
+#endif
+#include "buffer.hpp"
+
+
+#define _DEC_NONE 0
+#define _DEC_ZLIB 1
+#define _DEC_BROTLI 2
+
+// most bytes decompressed from one body, more is taken as decompression bomb
+#define DECODE_LIMIT (64 * 1024 * 1024)
+
+// value of Accept-Encoding request header, lists codings supported by Decoder
+#ifdef HAVE_BROTLI
+#define ACCEPT_ENCODING "gzip, deflate, br"
+#else
+#define ACCEPT_ENCODING "gzip, deflate"
+#endif
+
+
+/*
+ * Decoder of content coding, body is decompressed piece by piece as it is received.
+ * One decoder can be reused for multiple responses, it is prepared for each of them by init().
+ */
+class Decoder {
+private:
+	int type;       // type of active decoder
+	bool finished;  // end of compressed stream was reached
+	bool raw;       // deflate without zlib wrapper is being decoded
+	bool detected;  // wrapper of zlib stream is known, output was produced or raw deflate was chosen
+	std::string head;  // input given before wrapper was known, decoded again as raw deflate
+	bool empty;     // no compressed data was given yet, response may have no body at all
+	size_t produced;  // bytes decompressed from current body
+
+	z_stream zlib;  // gzip and deflate decoder state
+	bool zlib_ready;
+#ifdef HAVE_BROTLI
+	BrotliDecoderState *brotli;
+#endif
+
+	// release state of active decoder
+	void reset();
+	// count n decompressed bytes, false if body grew over DECODE_LIMIT
+	bool count(size_t n);
+	// decompress input with zlib
+	bool inflate_data(std::string_view in, Buffer &out);
+#ifdef HAVE_BROTLI
+	// decompress input with brotli
+	bool brotli_data(std::string_view in, Buffer &out);
+#endif
+
+public:
+	Decoder();
+	~Decoder();
+
+	// prepare decoder for value of Content-Encoding header, returns false for unsupported coding
+	bool init(std::string encoding);
+	// check if body needs to be decoded
+	bool active();
+	// decompress next piece of body and append it to out
+	bool decode(std::string_view in, Buffer &out);
+	// check if whole compressed stream was decoded, body without any data (204, 304) is complete
+	bool done();
+};
+
+#endif
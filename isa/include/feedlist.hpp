@@ -0,0 +1,66 @@
+/*
+ * feedlist.hpp
+ *
+ * List of feed urls loaded from feedfile.
+ *
+ * Project: Reader of news feed in format Atom & RSS with support of TLS
+ * Author: Matus Remen (xremen01@stud.fit.vutbr.cz)
+ * Date: 17.10.2026
+ */
+
+#ifndef _FEEDLIST_HPP
+#define _FEEDLIST_HPP
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <string_view>
+
+
+// fewest lines checked by one thread, smaller lists are checked by calling thread only
+#define FEEDLIST_CHUNK 16384
+
+
+/*
+ * Feed urls of feedfile or of single url argument.
+ * Feedfile is mapped to memory and urls are views into the mapping, nothing is copied.
+ * Only regular files can be mapped, other feedfiles (pipes, /dev/stdin) are read into memory.
+ * Empty lines and comments ('#') are skipped, invalid urls are reported and dropped,
+ * repeated urls are fetched only once, all before any request is made.
+ */
+class FeedList {
+private:
+	std::string single;     // url given as argument
+	char *map;              // mapped feedfile
+	size_t size;            // size of mapping
+	std::string content;    // feedfile which can't be mapped (pipe, terminal), read whole
+	std::vector<std::string_view> lines;  // urls of feedfile in order of lines
+	std::vector<std::string_view> list;   // valid unique urls
+
+	// split mapped file into lines without empty lines and comments
+	void index(const char *data, size_t size);
+	// read feedfile which can't be mapped into content
+	bool read_all(int fd);
+	// check syntax of lines in parallel, drop invalid and repeated urls
+	void validate(unsigned int threads);
+
+public:
+	FeedList();
+	~FeedList();
+
+	FeedList(const FeedList &) = delete;
+	FeedList &operator=(const FeedList &) = delete;
+
+	// use single url given as argument
+	void set_url(std::string url, unsigned int threads = 0);
+	// load urls from feedfile, threads == 0 uses all processors for validation
+	bool load(std::string path, unsigned int threads = 0);
+
+	// url has supported scheme and valid syntax, same check as requests do
+	static bool valid(std::string_view url);
+
+	// valid unique urls, views are valid as long as list exists
+	const std::vector<std::string_view> &urls();
+};
+
+#endif
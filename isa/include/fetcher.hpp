@@ -0,0 +1,117 @@
+/*
+ * fetcher.hpp
+ *
+ * Concurrent fetching of multiple feeds with ordered delivery of responses.
+ *
+ * Project: Reader of news feed in format Atom & RSS with support of TLS
+ * Author: Matus Remen (xremen01@stud.fit.vutbr.cz)
+ * Date: 17.10.2026
+ */
+
+#ifndef _FETCHER_HPP
+#define _FETCHER_HPP
+
+#include <mutex>
+#include <memory>
+#include <string>
+#include <ostream>
+#include <vector>
+#include <functional>
+#include <condition_variable>
+#include "client.hpp"
+#include "output.hpp"
+#include "scheduler.hpp"
+
+
+// number of finished responses a worker may run ahead of the consumer, per worker
+#define FETCH_WINDOW 4
+// number of classes of feed age, feeds of one class have equal priority and hosts take turns
+#define FETCH_CLASSES 8
+
+
+/*
+ * Fetcher spreads requests over a pool of worker threads, each owning its own Client.
+ * Clients are kept between runs, so their trust stores and idle connections are reused.
+ * Responses are handed to the consumer strictly in the order of the url list,
+ * no matter in which order they were downloaded. Which url is fetched next is decided
+ * by scheduler, feeds which changed recently (by response cache) go first.
+ */
+class Fetcher {
+private:
+	std::string certfile;
+	std::string certaddr;
+	unsigned int jobs;  // maximum number of simultaneous requests
+	SessionCache *sessions;  // TLS sessions shared by all workers
+	HttpCache *cache;        // response cache shared by all workers
+	Resolver resolver;       // host name lookups shared by all workers during the run
+	struct timeouts timeouts;  // time limits of each request
+	Scheduler scheduler;       // order of requests and limits of hosts
+	std::vector<std::unique_ptr<Client>> clients;  // clients not used by any worker now
+
+	// result slot for one url
+	struct slot {
+		bool done;
+		Buffer data;             // received response
+		std::string_view body;   // response body inside data
+		std::string output;      // text printed while processing url in streaming mode
+	};
+
+	std::vector<struct slot> slots;
+	std::mutex lock;
+	std::condition_variable fetched;   // signaled when some slot is done
+
+	// configure client of worker with shared caches and limits
+	void setup(Client &client);
+	// take idle client or create new one
+	std::unique_ptr<Client> acquire();
+	// return client for use by later workers and runs
+	void release(std::unique_ptr<Client> client);
+	// start resolving hosts of all urls in background
+	void prefetch(const std::vector<std::string_view> &urls);
+	// start scheduling urls, window is number of urls which may be fetched ahead of consumer,
+	// priorities reorder urls only inside the window
+	void plan(const std::vector<std::string_view> &urls, size_t window);
+	// worker thread body, runs task for url indexes given by scheduler until all urls are taken
+	void worker(std::function<void(Client &, size_t)> task);
+	// run task filling slot for each of count urls in worker threads, deliver is called
+	// for every done slot in list order
+	void dispatch(size_t count, std::function<void(Client &, size_t)> task, std::function<void(size_t)> deliver);
+
+public:
+	Fetcher(std::string certfile, std::string certaddr, unsigned int jobs);
+	~Fetcher();
+
+	// share TLS session cache among all clients of the fetcher
+	void set_session_cache(SessionCache *sessions);
+	// share response cache among all clients of the fetcher
+	void set_http_cache(HttpCache *cache);
+
+	// set time limits of each request
+	void set_timeouts(struct timeouts timeouts);
+	// set limits of requests to one host
+	void set_host_limits(struct host_limits limits);
+
+	// return maximum number of simultaneous requests
+	unsigned int get_jobs();
+
+	// forget host name lookups of previous runs, used by long running process before each run
+	void refresh();
+	// sum of counters of all clients, complete only between runs
+	struct client_stats get_client_stats();
+
+	// fetch all urls and call handler with index, receive buffer and response body as soon as each
+	// of them is received, handler is called in worker threads in any order and may take over buffer,
+	// only urls within window ahead of position reported by advance() are fetched (0 means no limit)
+	void fetch(const std::vector<std::string_view> &urls, std::function<void(size_t, Buffer &, std::string_view)> handler,
+		size_t window = 0);
+	// consumer of fetch() finished all urls before index consumed
+	void advance(size_t consumed);
+	// fetch all urls and call handler with index and response body for each of them in list order
+	void run(const std::vector<std::string_view> &urls, std::function<void(size_t, std::string_view)> handler);
+	// run job for each url with index, worker's client and stream to print to, job's output
+	// is printed to output in list order (sequential mode prints directly while job runs)
+	void stream(const std::vector<std::string_view> &urls, std::function<void(size_t, Client &, std::ostream &)> job,
+		Output &output);
+};
+
+#endif
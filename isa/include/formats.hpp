@@ -0,0 +1,78 @@
+/*
+ * formats.hpp
+ *
+ * Registry of supported feed formats and their detection.
+ *
+ * Project: Reader of news feed in format Atom & RSS with support of TLS
+ * Author: Matus Remen (xremen01@stud.fit.vutbr.cz)
+ * Date: 17.10.2026
+ */
+
+#ifndef _FORMATS_HPP
+#define _FORMATS_HPP
+
+#include <string_view>
+#include "tags.hpp"
+
+
+#define _ATOM 1
+#define _RSS2 2
+#define _RDF  3
+#define _JSON 4
+#define FORMAT_COUNT 5
+
+
+// fields of message
+enum field {
+	FIELD_TITLE,
+	FIELD_TIMESTAMP,
+	FIELD_AUTHOR,
+	FIELD_REFERENCE,
+	FIELD_ID,
+	FIELD_COUNT,
+};
+
+// fields of one message, text is held by arena or parsed document
+struct record {
+	std::string_view fields[FIELD_COUNT];
+};
+
+
+/*
+ * Description of feed format. XML formats are read by parsers through their elements,
+ * a new XML format is supported by adding its description and field rules.
+ */
+struct format {
+	int id;                // _ATOM, _RSS2, _RDF or _JSON
+	const char *name;
+	enum tag root;         // root element, TAG_OTHER for formats which are not XML
+	enum tag channel;      // element holding feed title, TAG_OTHER if it is the root
+	enum tag entry;        // element of one message
+	bool entries_in_root;  // messages are children of root instead of channel (RSS 1.0)
+};
+
+// field of message read from child element of entry
+struct field_rule {
+	int format;         // format the rule belongs to
+	enum tag tag;       // element holding the field
+	enum field field;   // field filled from the element
+	const char *attr;   // attribute holding value, nullptr for text of element
+	bool fallback;      // field is taken from the element only if no other element fills it
+};
+
+
+// recognize format from first bytes of feed without parsing it, nullptr if format is not supported
+// only XML prolog (declaration, comments, doctype) and name of root element are looked at
+const struct format *detect_format(std::string_view data);
+// format of XML document with root element, nullptr if not supported
+const struct format *format_by_root(enum tag root);
+// description of format with id
+const struct format *format_by_id(int id);
+
+// rule reading field of format from element with tag, nullptr if tag holds no field
+const struct field_rule *find_rule(int format, enum tag tag);
+
+// data without byte order mark and leading white space
+std::string_view skip_space(std::string_view data);
+
+#endif
@@ -0,0 +1,95 @@
+/*
+ * http.hpp
+ *
+ * Incremental parser of HTTP/1.1 responses working in place on receive buffer.
+ *
+ * Project: Reader of news feed in format Atom & RSS with support of TLS
+ * Author: Matus Remen (xremen01@stud.fit.vutbr.cz)
+ * Date: 17.10.2026
+ */
+
+#ifndef _HTTP_HPP
+#define _HTTP_HPP
+
+#include <map>
+#include <string>
+#include <string_view>
+#include "buffer.hpp"
+
+
+// results of HttpParser::parse()
+#define HTTP_MORE 0   // more data are needed
+#define HTTP_DONE 1   // whole response was parsed
+#define HTTP_ERROR 2  // response is malformed
+
+// maximum size of response head
+#define HTTP_MAX_HEAD 65536
+
+
+// http response structure, holds parsed response properties
+struct response {
+	std::string version;
+	std::string status_code;
+	std::map<std::string, std::string> headers;   // header names in lower case
+	std::map<std::string, std::string> trailers;  // trailer fields of chunked body, names in lower case
+	std::string_view body;  // view into receive buffer
+	bool keep_alive;        // connection may be used for next request
+};
+
+
+/*
+ * Parser is fed by the buffer data are received into, every call processes bytes appended since
+ * the previous one. Interim 1xx responses are skipped. Body framed by Content-Length, chunked
+ * transfer coding or end of connection is decoded in place: decoded body bytes are kept together
+ * right behind the head, so body is available as a view into the buffer without copying.
+ */
+class HttpParser {
+private:
+	enum parser_state {
+		HEAD,         // reading status line and header fields
+		CHUNK_SIZE,   // reading chunk size line
+		CHUNK_DATA,   // reading chunk payload
+		CHUNK_END,    // reading CRLF behind chunk payload
+		TRAILER,      // reading trailer fields behind last chunk
+		BODY_LENGTH,  // reading body of known length
+		BODY_EOF,     // reading body delimited by end of connection
+		DONE,
+		ERROR,
+	};
+
+	parser_state state;
+	size_t pos;         // processed raw bytes end here
+	size_t body_start;  // decoded body starts here
+	size_t body_end;    // decoded body ends here
+	size_t remaining;   // bytes left in current chunk or body of known length
+	size_t length;      // body length announced by Content-Length
+
+	// parse status line and header fields of response head
+	bool parse_head(std::string_view head, struct response &resp);
+	// parse one header field line and store it into fields
+	static void parse_field(std::string_view field, std::map<std::string, std::string> &fields);
+	// decide how body is framed once head is known
+	void start_body(struct response &resp);
+
+public:
+	HttpParser();
+	~HttpParser();
+
+	// prepare parser for next response, buffer is expected to be parsed from its beginning
+	void reset();
+	// process data received into buffer so far, returns HTTP_MORE, HTTP_DONE or HTTP_ERROR
+	int parse(Buffer &data, struct response &resp);
+	// connection was closed, returns HTTP_DONE if it ended response delimited by end of connection
+	int eof(Buffer &data, struct response &resp);
+	// drop decoded body and processed framing from buffer, used when body is passed on in pieces
+	void consume(Buffer &data);
+
+	// check if head of final response was parsed
+	bool head_done();
+	// return view of body decoded so far
+	std::string_view body(Buffer &data);
+	// return body length announced by Content-Length, 0 if unknown
+	size_t content_length();
+};
+
+#endif
@@ -0,0 +1,100 @@
+/*
+ * index.hpp
+ *
+ * In-memory index of latest parsed entries of feeds.
+ *
+ * Project: Reader of news feed in format Atom & RSS with support of TLS
+ * Author: Matus Remen (xremen01@stud.fit.vutbr.cz)
+ * Date: 17.10.2026
+ */
+
+#ifndef _INDEX_HPP
+#define _INDEX_HPP
+
+#include <map>
+#include <ctime>
+#include <string>
+#include <vector>
+#include <ostream>
+#include <string_view>
+#include <shared_mutex>
+#include "sink.hpp"
+
+
+// entry kept in index, text is owned by it
+struct stored_entry {
+	std::string title;
+	std::string timestamp;
+	std::string author;
+	std::string reference;
+	time_t time;  // parsed timestamp, time of fetch if entry has none
+};
+
+
+/*
+ * Index holds entries of the last successful parse of every feed. Whole feed is replaced
+ * at once, so readers never see half updated feed. Entries of all feeds are also ordered
+ * by time, newest entries are read without sorting. Index is read by many threads at once,
+ * writers exclude readers only while swapping the feed.
+ */
+class EntryIndex {
+private:
+	struct feed;
+	// entries of all feeds by time, newest last
+	typedef std::multimap<time_t, std::pair<const struct feed *, const struct stored_entry *>> timeline;
+
+	struct feed {
+		std::string url;
+		std::string title;
+		time_t fetched;  // time of last successful parse
+		std::vector<struct stored_entry> entries;  // in document order
+		std::vector<timeline::iterator> positions; // entries in timeline
+	};
+
+	std::map<std::string, struct feed, std::less<>> feeds;
+	timeline recent;
+	std::shared_mutex lock;
+
+	// write entry of feed through sink
+	static void write(std::ostream &out, Sink &sink, const struct feed &feed, const struct stored_entry &e, int idx);
+
+public:
+	EntryIndex();
+	~EntryIndex();
+
+	// replace entries of feed at url
+	void replace(std::string url, std::string title, std::vector<struct stored_entry> entries, time_t now);
+
+	// write one line per feed: url, time of last update, number of entries and title separated by tabs
+	void list(std::ostream &out);
+	// write entries of feed through sink, false if feed is not in index
+	bool entries(std::ostream &out, Sink &sink, std::string_view url);
+	// write count newest entries of all feeds through sink, newest first
+	void latest(std::ostream &out, Sink &sink, size_t count);
+	// number of feeds and entries in index
+	size_t feed_count();
+	size_t entry_count();
+};
+
+
+/*
+ * Sink collecting messages of one feed for index instead of printing them.
+ * Unlike other sinks it keeps state, one is created for each parsed feed.
+ */
+class IndexSink : public Sink {
+private:
+	std::string title;
+	std::vector<struct stored_entry> entries;
+	time_t now;  // time of fetch, for entries without timestamp
+
+public:
+	IndexSink(time_t now);
+
+	void feed(std::ostream &out, std::string_view url, std::string_view title) override;
+	void message(std::ostream &out, const struct entry &e, int idx) override;
+
+	// move collected feed to index under url
+	void commit(EntryIndex &index, std::string url);
+};
+
+#endif
@@ -0,0 +1,90 @@
+/*
+ * json.hpp
+ *
+ * Streaming reader of JSON documents and JSON Feed format.
+ *
+ * Project: Reader of news feed in format Atom & RSS with support of TLS
+ * Author: Matus Remen (xremen01@stud.fit.vutbr.cz)
+ * Date: 17.10.2026
+ */
+
+#ifndef _JSON_HPP
+#define _JSON_HPP
+
+#include <string>
+#include <vector>
+#include <string_view>
+#include "arena.hpp"
+#include "formats.hpp"
+
+
+/*
+ * Pull reader of JSON document. Values are read in single pass in order they appear,
+ * no tree is built, values of no interest are skipped without being decoded or validated.
+ * Reading stops at first syntax error, ok() tells whether document was read correctly.
+ */
+class JsonReader {
+private:
+	const char *pos;    // next unread character
+	const char *end;
+	bool failed;        // syntax error was found
+	bool after_value;   // value was read, comma or end of object/array follows
+	std::string key_buffer;
+
+	// skip white space, returns false at end of data
+	bool space();
+	// stop reading with error
+	bool fail();
+	// read string at current position, escaped strings are decoded into scratch
+	bool read_string(std::string_view &value, std::string &scratch);
+	// append UTF-8 encoding of code point
+	static void append_utf8(std::string &out, unsigned long code);
+	// read four hexadecimal digits of \u escape
+	bool read_hex(unsigned long &code);
+
+public:
+	JsonReader(std::string_view data);
+
+	// start reading object, false if next value is not object
+	bool object();
+	// read next key of current object, false at end of object
+	bool key(std::string_view &name);
+	// start reading array, false if next value is not array
+	bool array();
+	// check if current array has next value, false at end of array
+	bool next();
+	// read string value, false if next value is not string (it is left unread)
+	// view points into document or into scratch if string contained escape sequences
+	bool string(std::string_view &value, std::string &scratch);
+	// skip next value of any type
+	bool skip();
+
+	// document was read without error so far
+	bool ok();
+};
+
+
+/*
+ * Reader of feed in JSON Feed format (https://jsonfeed.org/version/1.1).
+ * Text of title and messages is copied into arena.
+ */
+class JsonFeed {
+private:
+	std::string scratch;  // decoded strings with escape sequences
+
+	// read string value into arena, value which is not string is skipped
+	bool read_text(JsonReader &json, Arena &arena, std::string_view &text);
+	// read name of author object
+	bool read_author(JsonReader &json, Arena &arena, std::string_view &author);
+	// read one item of feed
+	bool read_item(JsonReader &json, Arena &arena, struct record &item);
+
+public:
+	std::string_view title;
+	std::vector<struct record> items;
+
+	// read feed document, false if it is not valid JSON
+	bool read(std::string_view data, Arena &arena);
+};
+
+#endif
@@ -0,0 +1,62 @@
+/*
+ * output.hpp
+ *
+ * Batched program output with flush policy.
+ *
+ * Project: Reader of news feed in format Atom & RSS with support of TLS
+ * Author: Matus Remen (xremen01@stud.fit.vutbr.cz)
+ * Date: 17.10.2026
+ */
+
+#ifndef _OUTPUT_HPP
+#define _OUTPUT_HPP
+
+#include <string>
+#include <cstdint>
+#include <ostream>
+#include "writer.hpp"
+
+
+// flush policies
+#define FLUSH_FEED 1  // after output of each feed (and whenever buffer gets full)
+#define FLUSH_SIZE 2  // whenever threshold of buffered bytes is reached
+#define FLUSH_EXIT 3  // only at exit (and whenever buffer gets full)
+
+// default threshold of FLUSH_SIZE policy in bytes
+#define FLUSH_THRESHOLD (64 * 1024)
+// largest threshold, buffer of this size is allocated up front
+#define FLUSH_MAX (64 * 1024 * 1024)
+
+
+/*
+ * All messages are printed through output object. They are collected in buffer and written
+ * in large blocks, the policy decides how long output may wait in buffer. Output is used
+ * by one thread at a time, feeds printed in parallel are collected elsewhere and passed
+ * to output in order.
+ */
+class Output {
+private:
+	Writer writer;
+	std::ostream out;
+	int policy;
+
+public:
+	// output to file descriptor with policy, threshold is buffer size of FLUSH_SIZE policy
+	Output(int fd, int policy = FLUSH_FEED, size_t threshold = FLUSH_THRESHOLD);
+	~Output();
+
+	// stream messages are printed to, it must not be flushed by std::endl
+	std::ostream &stream();
+	// output of one feed is complete
+	void feed_done();
+	// write all buffered output, returns false if writing failed
+	bool flush();
+	// number of write system calls made so far
+	uint64_t writes();
+
+	// parse policy name ("feed", "exit" or threshold in bytes for size policy),
+	// returns false if it is not valid
+	static bool parse_policy(std::string name, int &policy, size_t &threshold);
+};
+
+#endif
@@ -13,51 +13,91 @@
 #define _PARSER_HPP
 
 
-#define _TS_OPT 1
-#define _AU_OPT 2
-#define _REF_OPT 4
-
-#define _ATOM 1
-#define _RSS2 2
-
+#include <memory>
 #include <string>
+#include <vector>
+#include <string_view>
 #include <iostream>
 #include <libxml/parser.h>
+#include "arena.hpp"
+#include "formats.hpp"
+#include "json.hpp"
+#include "poll.hpp"
+#include "seen.hpp"
+#include "sink.hpp"
+#include "tags.hpp"
 
 
 /*
  * Class for parsing messages from feeds.
- * Supported formats: Atom, RSS 2.0
+ * Supported formats: Atom, RSS 2.0, RSS 1.0 (RDF), JSON Feed, see formats.hpp
  *
  * Provides option to display message timestamps, author names and references.
  */
 class Parser {
 private:
-	std::string feed;    // repsponse body - feed
+	const struct format *format;  // format recognized from beginning of feed, nullptr if not supported
 	xmlDocPtr document;  // feed xml document object
 	xmlNodePtr root;     // root node of xml document
+	JsonFeed json;       // feed in JSON Feed format
+	bool json_valid;     // JSON feed was read without error
 	char filter;         // filter with display options
+	std::ostream &out;   // stream where messages are printed
+	Sink *sink;          // format of printed messages
+	std::unique_ptr<Sink> text_sink;  // default text format with display filter
+
+	SeenStore *seen;     // entries printed by previous runs, nullptr prints all entries
+	std::string url;     // url of feed, entries are stored under it
+	PollStore *poll;     // update history of feeds, nullptr if it is not kept
+	struct poll_sample sample;  // entries of feed for update history
+	Arena arena;         // text of feed title and entries, freed together with document
+	TagCache tags;       // recognized element names of document
+	std::string_view feed_title;
+
+	// print feed title
+	void emit_title(std::string_view title);
+	// print message unless it is empty or already seen
+	void emit_message(struct record &msg, int &idx);
 
-	// strip unwanted characters outside xml document
+	// read fields of entry element in single pass over its children
+	void extract(xmlNodePtr entry, int format, struct record &msg);
+	// print title of channel and messages of entries element, children are walked only once
+	// entries is the channel itself except of RSS 1.0
+	void parse_channel(xmlNodePtr channel, xmlNodePtr entries, const struct format *format);
+
+	// strip unwanted characters outside xml document, returns view of the document, nothing is copied
 	// 'https://www.fit.vut.cz/fit/news-rss/' contained unwanted characters outside xml which caused
 	// xml document setup lead to failure
-	void strip_feed();
+	static std::string_view strip_feed(std::string_view feed);
+
+	// check if entry was not printed yet and remember it, always true without store
+	bool unseen(std::string_view id, std::string_view reference, std::string_view title);
 
-	// print structured message considering display filter
-	void print_message(std::string title, std::string ts, std::string au, std::string ref, int idx);
-	// method for parsing feed in Atom format
-	void parse_atom();
-	// method for parsing feed in RSS 2.0 format
-	void parse_rss2();
+	// method for parsing feed in one of XML formats, false if feed could not be read
+	bool parse_xml();
+	// method for printing feed in JSON Feed format, false if feed is not valid
+	bool parse_json();
 
 public:
-	Parser(std::string feed, bool _ts, bool _au, bool _ref);
+	// feed is only read while parser is constructed, it does not have to outlive the parser
+	Parser(std::string_view feed, bool _ts, bool _au, bool _ref, std::ostream &out = std::cout);
 	~Parser();
 
+	// print only entries not printed by previous runs for feed at url, nullptr prints all
+	void set_seen_store(SeenStore *seen, std::string url);
+	// print messages of feed at url in format of sink instead of default text
+	void set_sink(Sink *sink, std::string url);
+	// record entries of successfully parsed feed at url in update history, nullptr keeps no history
+	void set_poll_store(PollStore *poll, std::string url);
+
 	// Method for parsing feed, recognizes format and calls respective private parsing method
 	// for the format.
-	// prints feed messages
-	void parse_feed();
+	// prints feed messages, returns false if feed could not be read
+	bool parse_feed();
+
+	// key under which entry is remembered: its id (Atom <id>, RSS <guid>), link if it has no id,
+	// title as last resort
+	static std::string_view entry_key(std::string_view id, std::string_view reference, std::string_view title);
 };
 
 #endif
@@ -0,0 +1,82 @@
+/*
+ * pipeline.hpp
+ *
+ * Fetching, parsing and printing of feeds in separate concurrent stages.
+ *
+ * Project: Reader of news feed in format Atom & RSS with support of TLS
+ * Author: Matus Remen (xremen01@stud.fit.vutbr.cz)
+ * Date: 17.10.2026
+ */
+
+#ifndef _PIPELINE_HPP
+#define _PIPELINE_HPP
+
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <ostream>
+#include <functional>
+#include <condition_variable>
+#include "buffer.hpp"
+#include "fetcher.hpp"
+#include "output.hpp"
+#include "queue.hpp"
+
+
+// number of fetched feeds which may wait for parser, per parser thread
+#define PARSE_QUEUE 4
+
+
+/*
+ * Pipeline runs three stages: workers of fetcher download feeds and put their bodies
+ * on a bounded queue, pool of parser threads turns them into text and output stage
+ * (calling thread) prints texts in order of url list. Stages are connected by bounded
+ * buffers, so memory use is limited even if one of them is much slower than others.
+ */
+class Pipeline {
+private:
+	Fetcher &fetcher;
+	unsigned int parsers;  // number of parser threads
+
+	// fetched feed waiting for parser
+	struct job {
+		size_t idx;
+		Buffer data;             // received response
+		std::string_view body;   // response body inside data
+	};
+
+	// counters of one stage
+	struct counters {
+		std::atomic<uint64_t> items{0};    // processed feeds
+		std::atomic<uint64_t> bytes{0};    // size of processed data
+		std::atomic<uint64_t> busy_us{0};  // time spent processing, summed over threads
+	};
+	struct counters fetched, parsed, printed;
+
+	// parsed feeds waiting for output, by index in url list
+	std::map<size_t, std::string> results;
+	size_t peak_results;  // highest number of results waiting for output
+	std::mutex lock;
+	std::condition_variable result_ready;  // signaled when feed is parsed
+
+	std::chrono::steady_clock::time_point started;
+	std::chrono::steady_clock::time_point finished;
+	size_t peak_queue;     // statistics of parse queue from last run
+	double average_queue;
+
+public:
+	Pipeline(Fetcher &fetcher, unsigned int parsers);
+	~Pipeline();
+
+	// fetch all urls, parse each of them by calling parse with its index, body and stream for
+	// the text, texts are printed to output in list order
+	void run(const std::vector<std::string_view> &urls, std::function<void(size_t, std::string_view, std::ostream &)> parse,
+		Output &output);
+	// print queue depths and throughput of stages of last run, one line per stage
+	void print_stats(std::ostream &out);
+};
+
+#endif
@@ -0,0 +1,88 @@
+/*
+ * poll.hpp
+ *
+ * Polling intervals of feeds learned from their update history.
+ *
+ * Project: Reader of news feed in format Atom & RSS with support of TLS
+ * Author: Matus Remen (xremen01@stud.fit.vutbr.cz)
+ * Date: 17.10.2026
+ */
+
+#ifndef _POLL_HPP
+#define _POLL_HPP
+
+#include <map>
+#include <ctime>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <string_view>
+
+
+// bounds of polling interval in seconds
+#define POLL_MIN 300
+#define POLL_MAX 86400
+// interval of feed which changed but its update frequency can not be estimated yet
+#define POLL_DEFAULT 3600
+// growth of interval after each fetch which found feed unchanged
+#define POLL_BACKOFF 1.5
+// number of newest entry timestamps used to estimate update frequency
+#define POLL_HISTORY 10
+// identification of poll file format
+#define POLL_MAGIC "FRPOLL1"
+
+
+// what one fetch of feed showed, filled by parser while messages are read
+struct poll_sample {
+	uint64_t digest = 0;         // fingerprint of keys of all entries in document order
+	std::vector<time_t> times;   // timestamps of entries which could be read
+};
+
+
+/*
+ * History of feeds polled by previous runs, kept in text file between runs.
+ * Every fetched feed is compared to its previous state by fingerprint of its entries,
+ * unchanged feed (also the one answered by 304 Not Modified from cache) is polled
+ * less and less often, changed feed gets interval estimated from gaps between
+ * timestamps of its entries. Feed is due once its interval elapsed since last check.
+ * Store is thread safe, parsers of all feeds update it at once.
+ */
+class PollStore {
+private:
+	// state of one feed
+	struct state {
+		time_t checked;   // time of last successful fetch
+		double interval;  // seconds between checks
+		uint64_t digest;  // fingerprint of entries at last check
+	};
+
+	std::map<std::string, struct state, std::less<>> feeds;
+	std::mutex lock;
+
+	// estimate seconds between updates from timestamps of entries, 0 if it can not be estimated
+	static double estimate(std::vector<time_t> times);
+
+public:
+	PollStore();
+	~PollStore();
+
+	// load history from file, returns false if file could not be read or is not poll file
+	bool load(std::string path);
+	// save history to file, file is replaced only once it is completely written
+	bool save(std::string path);
+
+	// feed is unknown or its interval elapsed since last check
+	bool due(std::string_view url, time_t now);
+	// time when feed gets due, 0 for unknown feed
+	time_t due_time(std::string_view url);
+	// learn from successful fetch of feed at time now
+	void update(std::string_view url, struct poll_sample &sample, time_t now);
+
+	// add entry with key and timestamp text to sample
+	static void observe(struct poll_sample &sample, std::string_view key, std::string_view timestamp);
+	// parse timestamp in format of RFC 822 (RSS) or RFC 3339 (Atom, JSON Feed, Dublin Core), 0 if it is not valid
+	static time_t parse_time(std::string_view text);
+};
+
+#endif
@@ -0,0 +1,103 @@
+/*
+ * queue.hpp
+ *
+ * Bounded blocking queue connecting stages of processing pipeline.
+ *
+ * Project: Reader of news feed in format Atom & RSS with support of TLS
+ * Author: Matus Remen (xremen01@stud.fit.vutbr.cz)
+ * Date: 17.10.2026
+ */
+
+#ifndef _QUEUE_HPP
+#define _QUEUE_HPP
+
+#include <deque>
+#include <mutex>
+#include <cstddef>
+#include <cstdint>
+#include <condition_variable>
+
+
+/*
+ * Thread safe FIFO queue with limited capacity. Producers block while queue is full,
+ * so a slow stage holds back the one before it instead of letting data pile up.
+ * Queue keeps statistics of its depth seen by producers.
+ */
+template <typename T>
+class BoundedQueue {
+private:
+	std::deque<T> items;
+	size_t capacity;
+	bool closed;
+	std::mutex lock;
+	std::condition_variable not_full;
+	std::condition_variable not_empty;
+
+	uint64_t pushed;     // number of pushed items
+	uint64_t depth_sum;  // sum of depths after each push, for average depth
+	size_t max_depth;    // highest depth reached
+
+public:
+	BoundedQueue(size_t capacity){
+		this->capacity = capacity ? capacity : 1;
+		this->closed = false;
+		this->pushed = 0;
+		this->depth_sum = 0;
+		this->max_depth = 0;
+	}
+
+	// append item, blocks while queue is full, returns false if queue was closed
+	bool push(T item){
+		std::unique_lock<std::mutex> guard(lock);
+		not_full.wait(guard, [&]{ return closed || items.size() < capacity; });
+		if (closed)
+			return false;
+
+		items.push_back(std::move(item));
+		pushed++;
+		depth_sum += items.size();
+		if (items.size() > max_depth)
+			max_depth = items.size();
+		guard.unlock();
+		not_empty.notify_one();
+		return true;
+	}
+
+	// take first item, blocks while queue is empty, returns false once queue is closed and empty
+	bool pop(T &item){
+		std::unique_lock<std::mutex> guard(lock);
+		not_empty.wait(guard, [&]{ return closed || !items.empty(); });
+		if (items.empty())
+			return false;
+
+		item = std::move(items.front());
+		items.pop_front();
+		guard.unlock();
+		not_full.notify_one();
+		return true;
+	}
+
+	// no more items will be pushed, consumers finish remaining items
+	void close(){
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			closed = true;
+		}
+		not_full.notify_all();
+		not_empty.notify_all();
+	}
+
+	// highest number of items waiting in queue
+	size_t peak_depth(){
+		std::lock_guard<std::mutex> guard(lock);
+		return max_depth;
+	}
+
+	// average number of items waiting in queue right after push
+	double average_depth(){
+		std::lock_guard<std::mutex> guard(lock);
+		return pushed ? (double) depth_sum / pushed : 0;
+	}
+};
+
+#endif
@@ -0,0 +1,91 @@
+/*
+ * resolver.hpp
+ *
+ * Asynchronous resolution of host names with per-run cache of results.
+ *
+ * Project: Reader of news feed in format Atom & RSS with support of TLS
+ * Author: Matus Remen (xremen01@stud.fit.vutbr.cz)
+ * Date: 17.10.2026
+ */
+
+#ifndef _RESOLVER_HPP
+#define _RESOLVER_HPP
+
+#include <map>
+#include <deque>
+#include <mutex>
+#include <memory>
+#include <string>
+#include <vector>
+#include <functional>
+#include <condition_variable>
+#include <sys/socket.h>
+
+
+// maximum number of lookups running in background at once
+#define RESOLVE_JOBS 8
+
+
+// one address of host, port is filled in when connecting
+struct address {
+	struct sockaddr_storage addr;
+	socklen_t length;
+};
+
+
+/*
+ * Thread safe cache of host name lookups shared by all clients of one run.
+ * Names can be prefetched in background threads, so lookups of all hosts overlap
+ * with each other and with downloading. Result of each name (including failure)
+ * is looked up only once, clients asking for a name being resolved wait for it.
+ */
+class Resolver {
+public:
+	// function looking up addresses of host, returns false if host can't be resolved
+	typedef std::function<bool(const std::string &, std::vector<struct address> &)> lookup_function;
+
+private:
+	// result of one host name
+	struct entry {
+		bool started;   // lookup was taken by some thread
+		bool done;      // lookup finished
+		bool ok;        // host was resolved
+		std::vector<struct address> addresses;
+	};
+
+	// state shared with background threads, which may outlive the resolver while blocked in lookup
+	struct state {
+		std::mutex lock;
+		std::condition_variable resolved;  // signaled when some entry is done
+		std::map<std::string, struct entry> entries;
+		std::deque<std::string> queue;     // prefetched names waiting for a thread
+		unsigned int threads;              // number of running background threads
+		lookup_function lookup;
+	};
+	std::shared_ptr<struct state> shared;
+
+	// run lookup of host and store its result
+	static void run_lookup(std::shared_ptr<struct state> shared, const std::string &host);
+	// background thread body, resolves queued names until queue is empty
+	static void lookup_thread(std::shared_ptr<struct state> shared);
+
+public:
+	Resolver();
+	// resolver with custom lookup, e.g. stub for testing
+	Resolver(lookup_function lookup);
+	~Resolver();
+
+	// lookup of host using system resolver (getaddrinfo)
+	static bool system_lookup(const std::string &host, std::vector<struct address> &addresses);
+
+	// start resolving host in background if it is not known yet
+	void prefetch(std::string host);
+	// get addresses of host, waits for lookup in progress or resolves it in calling thread,
+	// returns false if host can't be resolved or it is not resolved within timeout (ms),
+	// with timeout >= 0 lookup runs in background and it is not waited for after timeout
+	bool resolve(std::string host, std::vector<struct address> &addresses, int timeout = -1);
+	// forget results of finished lookups, names are looked up again next time they are needed
+	void forget();
+};
+
+#endif
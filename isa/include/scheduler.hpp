@@ -0,0 +1,96 @@
+/*
+ * scheduler.hpp
+ *
+ * Order of requests with per-host limits and priorities.
+ *
+ * Project: Reader of news feed in format Atom & RSS with support of TLS
+ * Author: Matus Remen (xremen01@stud.fit.vutbr.cz)
+ * Date: 17.10.2026
+ */
+
+#ifndef _SCHEDULER_HPP
+#define _SCHEDULER_HPP
+
+#include <set>
+#include <mutex>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <utility>
+#include <string_view>
+#include <condition_variable>
+
+
+// default limits of one host
+#define HOST_CONNECTIONS 4
+#define HOST_RATE        0
+#define HOST_BURST       4
+
+// limits of requests to one host (host:port), 0 means no limit
+struct host_limits {
+	unsigned int connections = HOST_CONNECTIONS;  // simultaneous requests
+	double rate = HOST_RATE;                      // started requests per second on average
+	unsigned int burst = HOST_BURST;              // requests which may be started at once after idle time
+};
+
+
+/*
+ * Scheduler decides which url is fetched next. Requests to one host are limited by number
+ * of simultaneous requests and by token bucket of its rate, so raising the number of jobs
+ * does not flood any single server. Among urls which may be started, the one with the lowest
+ * priority value goes first, ties are given to host served longest ago, so busy or slow host
+ * can not hold back the others.
+ * Only urls within window ahead of consumer are started, which keeps memory of ordered
+ * delivery limited.
+ */
+class Scheduler {
+private:
+	// state of one host
+	struct host {
+		unsigned int active;      // requests running now
+		double tokens;            // requests which may be started now by rate limit
+		std::chrono::steady_clock::time_point refilled;  // last update of tokens
+		uint64_t served;          // turn in which host was last given a request
+		std::set<std::pair<long, size_t>> queue;  // admitted urls by priority and index
+	};
+
+	struct host_limits limits;
+	std::vector<struct host> hosts;
+	std::vector<size_t> host_of;   // host index of each url
+	std::vector<long> priorities;  // priority of each url, lower goes first
+	std::vector<size_t> pending;   // hosts with admitted urls waiting
+	size_t count;     // number of urls
+	size_t window;    // urls ahead of consumer which may be started, 0 means all
+	size_t admitted;  // urls before index are in queues of their hosts
+	size_t horizon;   // urls before index may be admitted
+	size_t taken;     // number of urls handed out
+	uint64_t turn;    // counter of handed out urls, for fairness among hosts
+	std::mutex lock;
+	std::condition_variable changed;  // signaled when request finished or window moved
+
+	// move urls within window into queues of their hosts
+	void admit();
+	// add tokens earned since last refill
+	void refill(struct host &host, std::chrono::steady_clock::time_point now);
+
+public:
+	Scheduler();
+	~Scheduler();
+
+	// set limits of every host
+	void set_limits(struct host_limits limits);
+
+	// key of host of url, urls with the same key share limits
+	static std::string authority(std::string_view url);
+
+	// start scheduling urls, priorities may be empty (list order), window 0 means no limit
+	void start(const std::vector<std::string_view> &urls, const std::vector<long> &priorities, size_t window);
+	// take next url to fetch, blocks until some url may be started, false once all urls were taken
+	bool take(size_t &idx);
+	// request of url finished, its host may be given another one
+	void done(size_t idx);
+	// consumer finished all urls before index consumed, window moves forward
+	void advance(size_t consumed);
+};
+
+#endif
@@ -0,0 +1,74 @@
+/*
+ * seen.hpp
+ *
+ * Persistent store of feed entries printed by previous runs.
+ *
+ * Project: Reader of news feed in format Atom & RSS with support of TLS
+ * Author: Matus Remen (xremen01@stud.fit.vutbr.cz)
+ * Date: 17.10.2026
+ */
+
+#ifndef _SEEN_HPP
+#define _SEEN_HPP
+
+#include <mutex>
+#include <string>
+#include <cstdint>
+#include <string_view>
+
+
+// number of slots of newly created store, must be power of two
+#define SEEN_CAPACITY 65536
+// identification of store file format
+#define SEEN_MAGIC "FRSEEN1"
+
+
+/*
+ * Open addressing hash table of 64-bit fingerprints of (feed url, entry id) pairs
+ * kept in memory mapped file. Opening does not depend on number of stored entries,
+ * only the header is validated and the file is mapped. Table is doubled (rewritten
+ * to new file and renamed) when it gets three quarters full. Store is thread safe.
+ */
+class SeenStore {
+private:
+	// beginning of store file, followed by capacity slots, empty slot is 0
+	struct header {
+		char magic[8];
+		uint64_t capacity;
+		uint64_t count;
+	};
+
+	std::string path;
+	int fd;
+	struct header *table;  // mapped file
+	size_t size;           // size of mapping
+	std::mutex lock;
+
+	uint64_t *slots(){ return reinterpret_cast<uint64_t *>(table + 1); }
+
+	// fingerprint of entry, never 0
+	static uint64_t fingerprint(std::string_view feed, std::string_view id);
+	// create empty store file of given capacity and map it, returns false on failure
+	bool create(std::string file, uint64_t capacity);
+	// map already open file, returns false if it is not valid store
+	bool map();
+	// unmap and close current file
+	void unmap();
+	// insert fingerprint to table, returns false if it was already present
+	bool insert(uint64_t key);
+	// move entries to table of twice the size
+	bool grow();
+
+public:
+	SeenStore();
+	~SeenStore();
+
+	// open store file, it is created if it does not exist
+	bool open(std::string path);
+	// remember entry of feed, returns false if it was already stored before
+	bool add(std::string_view feed, std::string_view id);
+	// number of stored entries
+	uint64_t count();
+};
+
+#endif
@@ -0,0 +1,47 @@
+/*
+ * sessions.hpp
+ *
+ * Cache of TLS sessions for resumption of handshakes with already visited hosts.
+ *
+ * Project: Reader of news feed in format Atom & RSS with support of TLS
+ * Author: Matus Remen (xremen01@stud.fit.vutbr.cz)
+ * Date: 17.10.2026
+ */
+
+#ifndef _SESSIONS_HPP
+#define _SESSIONS_HPP
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <openssl/ssl.h>
+
+
+/*
+ * Thread safe map of authorities (host:port) to their last resumable TLS session.
+ * Cache can be shared by multiple clients and stored to file between runs.
+ */
+class SessionCache {
+private:
+	std::map<std::string, SSL_SESSION *> sessions;
+	std::mutex lock;
+
+	// check if session may still be offered to server
+	static bool alive(SSL_SESSION *session);
+
+public:
+	SessionCache();
+	~SessionCache();
+
+	// return session for authority with incremented reference count (caller frees it), nullptr if none
+	SSL_SESSION *get(std::string authority);
+	// store session for authority, cache takes over ownership of passed reference
+	void put(std::string authority, SSL_SESSION *session);
+
+	// load sessions from file in PEM format, returns false if file could not be read
+	bool load(std::string path);
+	// save all alive sessions to file in PEM format
+	bool save(std::string path);
+};
+
+#endif
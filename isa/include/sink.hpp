@@ -0,0 +1,123 @@
+/*
+ * sink.hpp
+ *
+ * Output formats of parsed feed messages.
+ *
+ * Project: Reader of news feed in format Atom & RSS with support of TLS
+ * Author: Matus Remen (xremen01@stud.fit.vutbr.cz)
+ * Date: 17.10.2026
+ */
+
+#ifndef _SINK_HPP
+#define _SINK_HPP
+
+#include <memory>
+#include <cstdint>
+#include <string>
+#include <ostream>
+#include <string_view>
+
+
+// display options of text output
+#define _TS_OPT 1
+#define _AU_OPT 2
+#define _REF_OPT 4
+
+// identification at the beginning of binary output
+#define BINARY_MAGIC "FEEDRDR1"
+
+
+// one parsed message together with feed it belongs to
+struct entry {
+	std::string_view feed;        // url of feed
+	std::string_view feed_title;  // title of feed, empty if it has none
+	std::string_view title;
+	std::string_view timestamp;
+	std::string_view author;
+	std::string_view reference;
+};
+
+
+/*
+ * Sink formats messages into output stream. Sinks do not keep any state between calls,
+ * so one sink can be used by multiple threads, each writing into its own stream.
+ * No method flushes the stream, buffering is left to its owner.
+ */
+class Sink {
+public:
+	virtual ~Sink();
+
+	// write text starting whole output
+	virtual void header(std::ostream &out);
+	// write text separating outputs of two consecutive feeds
+	virtual void separator(std::ostream &out);
+	// write feed title, called before messages of feed if feed has title
+	virtual void feed(std::ostream &out, std::string_view url, std::string_view title);
+	// write message, idx is order of message in feed
+	virtual void message(std::ostream &out, const struct entry &e, int idx) = 0;
+
+	// create sink of format "text", "jsonl", "csv" or "binary", filter applies to text only,
+	// returns nullptr for unknown format
+	static std::unique_ptr<Sink> create(std::string format, char filter);
+};
+
+
+/*
+ * Human readable text, messages separated by empty line when any optional field is printed.
+ */
+class TextSink : public Sink {
+private:
+	char filter;  // filter with display options
+
+public:
+	TextSink(char filter);
+
+	void separator(std::ostream &out) override;
+	void feed(std::ostream &out, std::string_view url, std::string_view title) override;
+	void message(std::ostream &out, const struct entry &e, int idx) override;
+};
+
+
+/*
+ * JSON Lines, one object per message with keys feed, feed_title, title, updated, author and link.
+ */
+class JsonSink : public Sink {
+private:
+	// write string as JSON string literal
+	static void write_string(std::ostream &out, std::string_view str);
+
+public:
+	void message(std::ostream &out, const struct entry &e, int idx) override;
+};
+
+
+/*
+ * CSV (RFC 4180) with header line, columns feed, feed_title, title, updated, author and link.
+ */
+class CsvSink : public Sink {
+private:
+	// write field, quoted if it contains separator, quote or line break
+	static void write_field(std::ostream &out, std::string_view field);
+
+public:
+	void header(std::ostream &out) override;
+	void message(std::ostream &out, const struct entry &e, int idx) override;
+};
+
+
+/*
+ * Binary records: output starts with 8 bytes of BINARY_MAGIC, each message is then
+ * a 32-bit length of the rest of record followed by six fields (feed, feed_title, title,
+ * updated, author, link), each of them a 32-bit length and its bytes. Integers are little endian.
+ */
+class BinarySink : public Sink {
+private:
+	// write 32-bit little endian number
+	static void write_u32(std::ostream &out, uint32_t value);
+
+public:
+	void header(std::ostream &out) override;
+	void message(std::ostream &out, const struct entry &e, int idx) override;
+};
+
+#endif
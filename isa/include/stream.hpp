@@ -0,0 +1,111 @@
+/*
+ * stream.hpp
+ *
+ * Streaming parser of Atom & RSS2.0 feeds built on libxml2 push parser.
+ *
+ * Project: Reader of news feed in format Atom & RSS with support of TLS
+ * Author: Matus Remen (xremen01@stud.fit.vutbr.cz)
+ * Date: 17.10.2026
+ */
+
+#ifndef _STREAM_HPP
+#define _STREAM_HPP
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <ostream>
+#include <string_view>
+#include <libxml/parser.h>
+#include <libxml/SAX2.h>
+#include "parser.hpp"
+
+
+/*
+ * Parser fed with feed document piece by piece as it is received.
+ * Messages are printed as soon as their closing tag is parsed, the document tree is never built,
+ * so memory use does not depend on feed size. Output is the same as of Parser.
+ * XML formats are read by rules of format registry, JSON Feed is read once it is received.
+ */
+class StreamParser {
+private:
+	xmlParserCtxtPtr context;  // libxml2 push parser context
+	std::ostream &out;         // stream where messages are printed
+	char filter;               // filter with display options
+	Sink *sink;                // format of printed messages
+	std::unique_ptr<Sink> text_sink;  // default text format with display filter
+	SeenStore *seen;           // entries printed by previous runs, nullptr prints all entries
+	std::string url;           // url of feed, entries are stored under it
+	PollStore *poll;           // update history of feeds, nullptr if it is not kept
+	struct poll_sample sample; // entries of feed for update history
+
+	const struct format *format;  // recognized feed format, nullptr until root element is known
+	TagCache tags;      // recognized element names of document
+	bool started;       // beginning of document was found in received data
+	bool failed;        // document is not well formed, further data are ignored
+	bool done;          // feed title and messages were read, further data are ignored
+	int depth;          // depth of currently open element, root element has depth 1
+	int channel_depth;  // depth of element holding feed title
+	bool channel_open;  // element holding feed title is being parsed
+	int entry_depth;    // depth of element holding messages, differs from channel_depth in RSS 1.0
+
+	// JSON Feed can not be printed piece by piece, it is collected and read when it is complete
+	bool json;
+	std::string json_data;
+
+	bool title_found;    // feed title element was parsed
+	bool title_printed;  // feed title was already printed
+	std::string feed_title;
+
+	// message currently being parsed
+	bool in_entry;
+	std::string fields[FIELD_COUNT];
+	int idx;  // number of printed messages
+
+	// text of element at capture_depth (and all its descendants) is appended to capture
+	std::string *capture;
+	int capture_depth;
+
+	// messages parsed before feed title, printed once title is known or document ends
+	struct message {
+		std::string title, timestamp, author, reference;
+	};
+	std::vector<struct message> pending;
+
+	// print message in format of sink
+	void print_message(struct message &msg);
+
+	// start capturing text of element at current depth into target
+	void capture_text(std::string *target);
+	// print finished message, or keep it until feed title is printed
+	void emit_message();
+	// print messages of collected JSON Feed, false if it is not valid
+	bool emit_json();
+	// print feed title and messages waiting for it
+	void emit_title();
+
+	// libxml2 SAX2 callbacks, ctx is the parser context, parser object is its _private
+	static void on_start(void *ctx, const xmlChar *name, const xmlChar *prefix, const xmlChar *uri,
+		int nb_namespaces, const xmlChar **namespaces, int nb_attributes, int nb_defaulted, const xmlChar **attributes);
+	static void on_end(void *ctx, const xmlChar *name, const xmlChar *prefix, const xmlChar *uri);
+	static void on_text(void *ctx, const xmlChar *text, int len);
+
+public:
+	StreamParser(bool _ts, bool _au, bool _ref, std::ostream &out);
+	~StreamParser();
+
+	// print only entries not printed by previous runs for feed at url, nullptr prints all
+	void set_seen_store(SeenStore *seen, std::string url);
+	// print messages of feed at url in format of sink instead of default text
+	void set_sink(Sink *sink, std::string url);
+	// record entries of successfully parsed feed at url in update history, nullptr keeps no history
+	void set_poll_store(PollStore *poll, std::string url);
+
+	// parse next piece of received feed, prints messages completed by it
+	void feed(std::string_view data);
+	// finish parsing after feed was received, complete is false if receiving failed part way,
+	// messages read so far are printed then but feed is not recorded in update history
+	void finish(bool complete = true);
+};
+
+#endif
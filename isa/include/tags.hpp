@@ -0,0 +1,80 @@
+/*
+ * tags.hpp
+ *
+ * Recognition of element names used by feed parsers.
+ *
+ * Project: Reader of news feed in format Atom & RSS with support of TLS
+ * Author: Matus Remen (xremen01@stud.fit.vutbr.cz)
+ * Date: 17.10.2026
+ */
+
+#ifndef _TAGS_HPP
+#define _TAGS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <libxml/xmlstring.h>
+
+
+// number of slots of tag cache, power of two
+#define TAG_CACHE 64
+
+
+// element names known to parsers, TAG_OTHER for everything else
+enum tag {
+	TAG_OTHER = 0,
+	TAG_FEED,
+	TAG_RSS,
+	TAG_CHANNEL,
+	TAG_TITLE,
+	TAG_ENTRY,
+	TAG_ITEM,
+	TAG_UPDATED,
+	TAG_PUBDATE,
+	TAG_AUTHOR,
+	TAG_LINK,
+	TAG_ID,
+	TAG_GUID,
+	TAG_RDF,
+	TAG_PUBLISHED,
+	TAG_DATE,
+	TAG_CREATOR,
+	TAG_COUNT,
+};
+
+
+// recognize element name, case insensitive, namespace prefix is not part of name
+// name length with its first and last letter select single candidate (perfect hash), so every name
+// is compared at most once no matter how many tags are known
+enum tag tag_id(const xmlChar *name);
+
+// name of known tag
+const char *tag_name(enum tag id);
+
+
+/*
+ * Tags of element names of one document.
+ * libxml2 interns element names in dictionary of document, so each distinct name has single address
+ * and is recognized only once, following elements with the same name cost one pointer compare.
+ * Valid only while the document (and its dictionary) exists.
+ */
+class TagCache {
+private:
+	const xmlChar *names[TAG_CACHE];
+	enum tag tags[TAG_CACHE];
+
+public:
+	TagCache();
+
+	// tag of interned element name
+	enum tag lookup(const xmlChar *name){
+		size_t slot = (reinterpret_cast<uintptr_t>(name) >> 3) & (TAG_CACHE - 1);
+		if (this->names[slot] != name){
+			this->names[slot] = name;
+			this->tags[slot] = tag_id(name);
+		}
+		return this->tags[slot];
+	}
+};
+
+#endif
@@ -0,0 +1,29 @@
+/*
+ * timeouts.hpp
+ *
+ * Time limits of single request.
+ *
+ * Project: Reader of news feed in format Atom & RSS with support of TLS
+ * Author: Matus Remen (xremen01@stud.fit.vutbr.cz)
+ * Date: 17.10.2026
+ */
+
+#ifndef _TIMEOUTS_HPP
+#define _TIMEOUTS_HPP
+
+
+// default time limits in milliseconds
+#define TIMEOUT_CONNECT    10000
+#define TIMEOUT_HANDSHAKE  10000
+#define TIMEOUT_FIRST_BYTE 30000
+#define TIMEOUT_TOTAL      300000
+
+// time limits of phases of request in milliseconds, 0 means no limit
+struct timeouts {
+	int connect = TIMEOUT_CONNECT;        // establishing TCP connection (all addresses of host)
+	int handshake = TIMEOUT_HANDSHAKE;    // TLS handshake
+	int first_byte = TIMEOUT_FIRST_BYTE;  // from sending request to first byte of response
+	int total = TIMEOUT_TOTAL;            // whole request including resolving host and reading body
+};
+
+#endif
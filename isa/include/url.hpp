@@ -0,0 +1,36 @@
+/*
+ * url.hpp
+ *
+ * Single pass scanner of absolute urls, parts are returned as views of the input.
+ *
+ * Project: Reader of news feed in format Atom & RSS with support of TLS
+ * Author: Matus Remen (xremen01@stud.fit.vutbr.cz)
+ * Date: 17.10.2026
+ */
+
+#ifndef _URL_HPP
+#define _URL_HPP
+
+#include <string_view>
+
+
+// parts of url "scheme://userinfo@host:port/path?query#fragment", all of them are views
+// into scanned string, missing parts are empty, host of IPv6 literal keeps its brackets
+struct url_view {
+	std::string_view scheme;
+	std::string_view userinfo;
+	std::string_view host;
+	std::string_view port;
+	std::string_view path;
+	std::string_view query;
+	std::string_view fragment;
+	bool has_query;     // '?' is present, query itself may be empty
+	bool has_fragment;  // '#' is present, fragment itself may be empty
+};
+
+
+// split url into its parts without allocating, returns false if url is not
+// an absolute url with authority ("scheme://host...") or contains bytes not allowed in it
+bool scan_url(std::string_view url, struct url_view &parts);
+
+#endif
@@ -0,0 +1,61 @@
+/*
+ * writer.hpp
+ *
+ * Buffered writer of program output.
+ *
+ * Project: Reader of news feed in format Atom & RSS with support of TLS
+ * Author: Matus Remen (xremen01@stud.fit.vutbr.cz)
+ * Date: 17.10.2026
+ */
+
+#ifndef _WRITER_HPP
+#define _WRITER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <streambuf>
+#include <string_view>
+
+
+// size of output buffer
+#define WRITER_BUFFER (1 << 20)
+
+
+/*
+ * Stream buffer collecting output in large memory buffer and writing it to file descriptor
+ * only when buffer gets full or on explicit flush, so printing a line does not cost a system call.
+ * Used through std::ostream, std::endl and std::flush still force a write.
+ */
+class Writer : public std::streambuf {
+private:
+	int fd;         // file descriptor output is written to
+	char *buffer;
+	size_t capacity;
+	bool failed;    // write to descriptor failed, further output is dropped
+	uint64_t calls; // number of write system calls
+
+	// write all bytes to descriptor, handles partial writes and interrupts
+	bool write_all(const char *data, size_t size);
+
+protected:
+	// buffer is full, write it out and store c
+	int_type overflow(int_type c) override;
+	// append bytes, large blocks bypass the buffer
+	std::streamsize xsputn(const char *data, std::streamsize size) override;
+	// explicit flush of stream
+	int sync() override;
+
+public:
+	Writer(int fd, size_t capacity = WRITER_BUFFER);
+	~Writer();
+
+	Writer(const Writer &) = delete;
+	Writer &operator=(const Writer &) = delete;
+
+	// write buffered output to descriptor, returns false if it failed
+	bool flush();
+	// number of write system calls made so far
+	uint64_t writes();
+};
+
+#endif
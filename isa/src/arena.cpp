@@ -0,0 +1,154 @@
+/*
+ * arena.cpp
+ *
+ * Arena holding text extracted from parsed feed document.
+ *
+ * Project: Reader of news feed in format Atom & RSS with support of TLS
+ * Author: Matus Remen (xremen01@stud.fit.vutbr.cz)
+ * Date: 17.10.2026
+ */
+
+#include <cstring>
+#include <libxml/entities.h>
+#include "../include/arena.hpp"
+
+
+Arena::Arena(){
+	this->top = nullptr;
+	this->left = 0;
+	this->total = 0;
+}
+
+
+char *Arena::allocate(size_t size){
+	if (size > this->left){
+		size_t block = size > ARENA_BLOCK ? size : ARENA_BLOCK;
+		this->blocks.push_back(std::unique_ptr<char[]>(new char[block]));
+		this->top = this->blocks.back().get();
+		this->left = block;
+		this->total += block;
+	}
+	char *data = this->top;
+	this->top += size;
+	this->left -= size;
+	return data;
+}
+
+
+std::string_view Arena::store(std::string_view data){
+	if (data.empty())
+		return std::string_view();
+	char *copy = allocate(data.size());
+	memcpy(copy, data.data(), data.size());
+	return std::string_view(copy, data.size());
+}
+
+
+size_t Arena::measure(xmlNodePtr node){
+	size_t size = 0;
+	for (; node; node = node->next){
+		switch (node->type){
+			case XML_TEXT_NODE:
+			case XML_CDATA_SECTION_NODE:
+				if (node->content)
+					size += strlen((const char *) node->content);
+				break;
+			case XML_ELEMENT_NODE:
+				size += measure(node->children);
+				break;
+			case XML_ENTITY_REF_NODE:{
+				xmlEntityPtr entity = xmlGetDocEntity(node->doc, node->name);
+				if (entity)
+					size += measure(entity->children);
+				break;}
+			default:
+				break;
+		}
+	}
+	return size;
+}
+
+
+char *Arena::fill(xmlNodePtr node, char *dst){
+	for (; node; node = node->next){
+		switch (node->type){
+			case XML_TEXT_NODE:
+			case XML_CDATA_SECTION_NODE:
+				if (node->content){
+					size_t size = strlen((const char *) node->content);
+					memcpy(dst, node->content, size);
+					dst += size;
+				}
+				break;
+			case XML_ELEMENT_NODE:
+				dst = fill(node->children, dst);
+				break;
+			case XML_ENTITY_REF_NODE:{
+				xmlEntityPtr entity = xmlGetDocEntity(node->doc, node->name);
+				if (entity)
+					dst = fill(entity->children, dst);
+				break;}
+			default:
+				break;
+		}
+	}
+	return dst;
+}
+
+
+std::string_view Arena::text(xmlNodePtr node){
+	if (!node)
+		return std::string_view();
+	if (node->type == XML_TEXT_NODE || node->type == XML_CDATA_SECTION_NODE)
+		return node->content ? std::string_view((const char *) node->content) : std::string_view();
+
+	// common case, element holds single piece of text which is borrowed from document
+	xmlNodePtr child = node->children;
+	if (!child)
+		return std::string_view();
+	if (!child->next && (child->type == XML_TEXT_NODE || child->type == XML_CDATA_SECTION_NODE))
+		return child->content ? std::string_view((const char *) child->content) : std::string_view();
+
+	size_t size = measure(child);
+	if (!size)
+		return std::string_view();
+	char *data = allocate(size);
+	fill(child, data);
+	return std::string_view(data, size);
+}
+
+
+std::string_view Arena::prop(xmlNodePtr node, const char *name){
+	xmlAttrPtr attr = xmlHasProp(node, (const xmlChar *) name);
+	if (!attr)
+		return std::string_view();
+	// attribute not present in document, default value is taken from DTD
+	if (attr->type == XML_ATTRIBUTE_DECL){
+		const xmlChar *value = ((xmlAttributePtr) attr)->defaultValue;
+		return value ? std::string_view((const char *) value) : std::string_view();
+	}
+
+	xmlNodePtr child = attr->children;
+	if (child && !child->next && child->type == XML_TEXT_NODE)
+		return child->content ? std::string_view((const char *) child->content) : std::string_view();
+
+	size_t size = measure(child);
+	if (!size)
+		return std::string_view();
+	char *data = allocate(size);
+	fill(child, data);
+	return std::string_view(data, size);
+}
+
+
+void Arena::clear(){
+	this->blocks.clear();
+	this->top = nullptr;
+	this->left = 0;
+	this->total = 0;
+}
+
+
+size_t Arena::allocated(){
+	return this->total;
+}
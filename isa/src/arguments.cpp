@@ -10,6 +10,7 @@
 
 #include "../include/arguments.hpp"
 #include <iostream>
+#include <cstdlib>
 
 
 Arguments::Arguments(int argc, char **argv){
@@ -17,6 +18,11 @@ Arguments::Arguments(int argc, char **argv){
 	_url_file = std::string();
 	_cert_file = std::string();
 	_certaddr = std::string();
+	_session_file = std::string();
+	_cache_dir = std::string();
+	_seen_file = std::string();
+	_poll_file = std::string();
+	_daemon_socket = std::string();
 
 	valid = parse_arguments(argc, argv);
 }
@@ -33,6 +39,58 @@ bool Arguments::check_required(){
 }
 
 
+bool Arguments::parse_timeouts(std::string list){
+	int *limits[] = {&_timeouts.connect, &_timeouts.handshake, &_timeouts.first_byte, &_timeouts.total};
+	size_t start = 0;
+
+	for (int *limit : limits){
+		size_t end = list.find(',', start);
+		std::string field = list.substr(start, end == std::string::npos ? std::string::npos : end - start);
+		if (!field.empty()){
+			char *rest = nullptr;
+			double seconds = strtod(field.c_str(), &rest);
+			if (*rest || seconds < 0 || seconds > 86400)
+				return false;
+			*limit = static_cast<int>(seconds * 1000);
+		}
+		if (end == std::string::npos)
+			return true;
+		start = end + 1;
+	}
+	// more than four fields
+	return false;
+}
+
+
+bool Arguments::parse_host_limits(std::string list){
+	size_t start = 0;
+
+	for (int i = 0; i < 3; i++){
+		size_t end = list.find(',', start);
+		std::string field = list.substr(start, end == std::string::npos ? std::string::npos : end - start);
+		if (!field.empty()){
+			char *rest = nullptr;
+			double value = strtod(field.c_str(), &rest);
+			if (*rest || value < 0 || value > 1000000)
+				return false;
+			if (i == 1)
+				_host_limits.rate = value;
+			else if (value != static_cast<unsigned int>(value))
+				return false;
+			else if (i == 0)
+				_host_limits.connections = static_cast<unsigned int>(value);
+			else
+				_host_limits.burst = static_cast<unsigned int>(value);
+		}
+		if (end == std::string::npos)
+			return true;
+		start = end + 1;
+	}
+	// more than three fields
+	return false;
+}
+
+
 bool Arguments::parse_arguments(int argc, char **argv){
 	enum opt_id{
 		FEEDFILE  = 'f',
@@ -41,15 +99,33 @@ bool Arguments::parse_arguments(int argc, char **argv){
 		TIMESTAMP = 'T',
 		AUTHORS   = 'a',
 		ASS_URL   = 'u',
+		JOBS      = 'j',
+		SESSIONS  = 's',
+		STREAM    = 'S',
+		CACHE     = 'd',
+		TIMEOUTS  = 't',
+		HOSTS     = 'H',
+		NEW_ONLY  = 'n',
+		POLL      = 'P',
+		DAEMON    = 'D',
+		PARSERS   = 'p',
+		FORMAT    = 'o',
+		FLUSH     = 'F',
+		STATS     = 256,
 		HELP      = 'h',
 	};
 	static const struct option long_opts[] = {
 		{"help", no_argument, nullptr, HELP},
+		{"new-only", required_argument, nullptr, NEW_ONLY},
+		{"poll", required_argument, nullptr, POLL},
+		{"daemon", required_argument, nullptr, DAEMON},
+		{"stats", no_argument, nullptr, STATS},
+		{"flush", required_argument, nullptr, FLUSH},
 		{nullptr, 0, nullptr, 0},
 	};
 	
 	int opt;
-	while ((opt = getopt_long(argc, argv, "f:c:C:Tauh", long_opts, nullptr)) != -1){
+	while ((opt = getopt_long(argc, argv, "f:c:C:Tauj:s:Sd:t:H:n:P:D:p:o:F:h", long_opts, nullptr)) != -1){
 		switch (opt){
 			case FEEDFILE:{
 				_url_file = std::string(optarg);
@@ -69,12 +145,76 @@ bool Arguments::parse_arguments(int argc, char **argv){
 			case ASS_URL:{
 				_opt_ref = true;
 				break;}
+			case CACHE:{
+				_cache_dir = std::string(optarg);
+				break;}
+			case STREAM:{
+				_opt_stream = true;
+				break;}
+			case SESSIONS:{
+				_session_file = std::string(optarg);
+				break;}
+			case JOBS:{
+				char *end = nullptr;
+				long jobs = strtol(optarg, &end, 10);
+				if (*end || jobs < 1){
+					std::cerr << "Invalid number of jobs '" << optarg << "'." << std::endl;
+					return false;
+				}
+				_jobs = static_cast<unsigned int>(jobs);
+				break;}
+			case PARSERS:{
+				char *end = nullptr;
+				long parsers = strtol(optarg, &end, 10);
+				if (*end || parsers < 1){
+					std::cerr << "Invalid number of parsers '" << optarg << "'." << std::endl;
+					return false;
+				}
+				_parsers = static_cast<unsigned int>(parsers);
+				break;}
+			case FORMAT:{
+				_format = std::string(optarg);
+				if (_format != "text" && _format != "jsonl" && _format != "csv" && _format != "binary"){
+					std::cerr << "Unknown output format '" << optarg << "'." << std::endl;
+					return false;
+				}
+				break;}
+			case FLUSH:{
+				if (!Output::parse_policy(std::string(optarg), _flush_policy, _flush_threshold)){
+					std::cerr << "Invalid flush policy '" << optarg << "'." << std::endl;
+					return false;
+				}
+				break;}
+			case STATS:{
+				_opt_stats = true;
+				break;}
+			case NEW_ONLY:{
+				_seen_file = std::string(optarg);
+				break;}
+			case POLL:{
+				_poll_file = std::string(optarg);
+				break;}
+			case DAEMON:{
+				_daemon_socket = std::string(optarg);
+				break;}
+			case TIMEOUTS:{
+				if (!parse_timeouts(std::string(optarg))){
+					std::cerr << "Invalid timeouts '" << optarg << "'." << std::endl;
+					return false;
+				}
+				break;}
+			case HOSTS:{
+				if (!parse_host_limits(std::string(optarg))){
+					std::cerr << "Invalid host limits '" << optarg << "'." << std::endl;
+					return false;
+				}
+				break;}
 			case HELP:{
 				print_usage();
 				_opt_help = true;
 				return true;}
 			case '?':{
-				if (optopt == 'f' || optopt == 'c' || optopt == 'C')
+				if (optopt == 'f' || optopt == 'c' || optopt == 'C' || optopt == 'j' || optopt == 's' || optopt == 'd' || optopt == 't' || optopt == 'H' || optopt == 'n' || optopt == 'P' || optopt == 'D' || optopt == 'p' || optopt == 'o' || optopt == 'F')
 					std::cerr << "Missing argument for option '-" << optopt << "'." << std::endl;
 				else
 					std::cerr << "Unknown option '" << optopt << "'." << std::endl;
@@ -122,6 +262,66 @@ std::string Arguments::get_certaddr(){
 }
 
 
+std::string Arguments::get_session_file(){
+	return _session_file;
+}
+
+
+std::string Arguments::get_cache_dir(){
+	return _cache_dir;
+}
+
+
+std::string Arguments::get_seen_file(){
+	return _seen_file;
+}
+
+
+std::string Arguments::get_poll_file(){
+	return _poll_file;
+}
+
+
+std::string Arguments::get_daemon_socket(){
+	return _daemon_socket;
+}
+
+
+unsigned int Arguments::get_jobs(){
+	return _jobs;
+}
+
+
+std::string Arguments::get_format(){
+	return _format;
+}
+
+
+int Arguments::get_flush_policy(){
+	return _flush_policy;
+}
+
+
+size_t Arguments::get_flush_threshold(){
+	return _flush_threshold;
+}
+
+
+unsigned int Arguments::get_parsers(){
+	return _parsers;
+}
+
+
+struct timeouts Arguments::get_timeouts(){
+	return _timeouts;
+}
+
+
+struct host_limits Arguments::get_host_limits(){
+	return _host_limits;
+}
+
+
 bool Arguments::ok(){
 	return valid;
 }
@@ -141,3 +341,22 @@ bool Arguments::ref(){
 	return _opt_ref;
 }
 
+
+bool Arguments::stream(){
+	return _opt_stream;
+}
+
+
+bool Arguments::stats(){
+	return _opt_stats;
+}
+
+
+bool Arguments::new_only(){
+	return !_seen_file.empty();
+}
+
+
+bool Arguments::daemon(){
+	return !_daemon_socket.empty();
+}
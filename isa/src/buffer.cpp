@@ -0,0 +1,128 @@
+/*
+ * buffer.cpp
+ *
+ * Growable byte buffer for receiving responses without intermediate copies.
+ *
+ * Project: Reader of news feed in format Atom & RSS with support of TLS
+ * Author: Matus Remen (xremen01@stud.fit.vutbr.cz)
+ * Date: 17.10.2026
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include "../include/buffer.hpp"
+
+
+Buffer::Buffer(){
+	this->bytes = nullptr;
+	this->capacity = 0;
+	this->length = 0;
+}
+
+
+Buffer::Buffer(Buffer &&other) noexcept {
+	this->bytes = other.bytes;
+	this->capacity = other.capacity;
+	this->length = other.length;
+
+	other.bytes = nullptr;
+	other.capacity = 0;
+	other.length = 0;
+}
+
+
+Buffer &Buffer::operator=(Buffer &&other) noexcept {
+	if (this == &other)
+		return *this;
+
+	free(this->bytes);
+	this->bytes = other.bytes;
+	this->capacity = other.capacity;
+	this->length = other.length;
+
+	other.bytes = nullptr;
+	other.capacity = 0;
+	other.length = 0;
+	return *this;
+}
+
+
+Buffer::~Buffer(){
+	free(this->bytes);
+}
+
+
+void Buffer::reserve(size_t size){
+	if (size <= this->capacity)
+		return;
+
+	char *grown = static_cast<char *>(realloc(this->bytes, size));
+	if (!grown)
+		throw std::bad_alloc();
+	this->bytes = grown;
+	this->capacity = size;
+}
+
+
+char *Buffer::space(size_t min){
+	if (this->capacity - this->length < min){
+		// grow geometrically so appending stays amortized linear
+		size_t size = this->capacity * 2;
+		if (size < this->length + min)
+			size = this->length + min;
+		reserve(size);
+	}
+	return this->bytes + this->length;
+}
+
+
+void Buffer::commit(size_t n){
+	this->length += n;
+}
+
+
+void Buffer::clear(){
+	this->length = 0;
+}
+
+
+void Buffer::truncate(size_t size){
+	if (size < this->length)
+		this->length = size;
+}
+
+
+void Buffer::erase(size_t pos, size_t n){
+	if (pos >= this->length)
+		return;
+	if (n > this->length - pos)
+		n = this->length - pos;
+
+	memmove(this->bytes + pos, this->bytes + pos + n, this->length - pos - n);
+	this->length -= n;
+}
+
+
+const char *Buffer::data() const {
+	return this->bytes;
+}
+
+
+char *Buffer::data(){
+	return this->bytes;
+}
+
+
+size_t Buffer::size() const {
+	return this->length;
+}
+
+
+std::string_view Buffer::view(size_t pos, size_t n) const {
+	if (pos >= this->length)
+		return std::string_view();
+	if (n > this->length - pos)
+		n = this->length - pos;
+	return std::string_view(this->bytes + pos, n);
+}
@@ -0,0 +1,160 @@
+/*
+ * cache.cpp
+ *
+ * On-disk cache of feed responses for conditional requests (ETag / Last-Modified).
+ *
+ * Project: Reader of news feed in format Atom & RSS with support of TLS
+ * Author: Matus Remen (xremen01@stud.fit.vutbr.cz)
+ * Date: 17.10.2026
+ */
+
+#include <cerrno>
+#include <cstdlib>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <openssl/evp.h>
+#include "../include/cache.hpp"
+
+// size of pieces in which cached body is read
+#define CACHE_READ_SIZE 65536
+
+
+HttpCache::HttpCache(std::string dir){
+	this->dir = dir;
+}
+
+
+HttpCache::~HttpCache(){}
+
+
+bool HttpCache::init(){
+	if (mkdir(dir.c_str(), 0755) && errno != EEXIST)
+		return false;
+
+	struct stat st;
+	return !stat(dir.c_str(), &st) && S_ISDIR(st.st_mode);
+}
+
+
+std::string HttpCache::path(std::string url){
+	// file name is SHA-256 of url in hex
+	unsigned char digest[EVP_MAX_MD_SIZE];
+	unsigned int length = 0;
+	EVP_Digest(url.c_str(), url.size(), digest, &length, EVP_sha256(), nullptr);
+
+	static const char hex[] = "0123456789abcdef";
+	std::string name;
+	for (unsigned int i = 0; i < length; i++){
+		name += hex[digest[i] >> 4];
+		name += hex[digest[i] & 0xf];
+	}
+	return dir + "/" + name;
+}
+
+
+// read one header line of cache file without trailing newline
+static bool read_line(FILE *file, std::string &line){
+	line.clear();
+	int c;
+	while ((c = fgetc(file)) != EOF && c != '\n')
+		line += static_cast<char>(c);
+	return c == '\n';
+}
+
+
+FILE *HttpCache::open_entry(std::string url, struct validators &v){
+	FILE *file = fopen(path(url).c_str(), "rb");
+	if (!file)
+		return nullptr;
+
+	// header: url, ETag and Last-Modified on separate lines, body follows
+	std::string cached_url;
+	if (!read_line(file, cached_url) || cached_url != url
+		|| !read_line(file, v.etag) || !read_line(file, v.last_modified)){
+		fclose(file);
+		return nullptr;
+	}
+	return file;
+}
+
+
+bool HttpCache::lookup(std::string url, struct validators &v){
+	FILE *file = open_entry(url, v);
+	if (!file)
+		return false;
+	fclose(file);
+	return !v.etag.empty() || !v.last_modified.empty();
+}
+
+
+time_t HttpCache::changed(std::string url){
+	// entry is rewritten only when server sends new body, not after 304 Not Modified
+	struct stat st;
+	if (stat(path(url).c_str(), &st))
+		return 0;
+	return st.st_mtime;
+}
+
+
+bool HttpCache::read(std::string url, Buffer &data, std::function<void(std::string_view)> consumer){
+	struct validators v;
+	FILE *file = open_entry(url, v);
+	if (!file)
+		return false;
+
+	data.clear();
+	size_t read;
+	do {
+		read = fread(data.space(CACHE_READ_SIZE), 1, CACHE_READ_SIZE, file);
+		data.commit(read);
+		if (consumer && read){
+			consumer(data.view());
+			data.clear();
+		}
+	} while (read);
+
+	bool ok = !ferror(file);
+	fclose(file);
+	return ok;
+}
+
+
+FILE *HttpCache::begin(std::string url, struct validators &v, std::string &tmp_path){
+	// validators are stored on separate lines, they can not contain line breaks
+	if (url.find('\n') != std::string::npos || v.etag.find('\n') != std::string::npos
+		|| v.last_modified.find('\n') != std::string::npos)
+		return nullptr;
+
+	std::string tmp = path(url) + ".XXXXXX";
+	int fd = mkstemp(&tmp[0]);
+	if (fd < 0)
+		return nullptr;
+
+	FILE *file = fdopen(fd, "wb");
+	if (!file){
+		close(fd);
+		unlink(tmp.c_str());
+		return nullptr;
+	}
+
+	if (fprintf(file, "%s\n%s\n%s\n", url.c_str(), v.etag.c_str(), v.last_modified.c_str()) < 0){
+		fclose(file);
+		unlink(tmp.c_str());
+		return nullptr;
+	}
+
+	tmp_path = tmp;
+	return file;
+}
+
+
+void HttpCache::end(std::string url, FILE *entry, std::string &tmp_path, bool complete){
+	if (!entry)
+		return;
+
+	bool ok = !ferror(entry);
+	ok = !fclose(entry) && ok;
+	if (!complete || !ok || rename(tmp_path.c_str(), path(url).c_str()))
+		unlink(tmp_path.c_str());
+	tmp_path.clear();
+}
@@ -9,6 +9,15 @@
  */
 
 
+#include <ctime>
+#include <cstring>
+#include <utility>
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <poll.h>
+#include <unistd.h>
+#include "../include/connect.hpp"
 #include "../include/client.hpp"
 
 
@@ -26,11 +35,65 @@ Client::Client(std::string certfile, std::string certaddr){
 
 	this->bio = nullptr;
 	this->ctx = nullptr;
+	this->sessions = nullptr;
+	this->resolver = &this->own_resolver;
+
+	this->streaming = false;
+	this->delivered = 0;
+	this->completed = false;
+
+	this->phase = "";
+	this->expired = false;
+
+	this->cache = nullptr;
+	this->cache_entry = nullptr;
 }
 
 
 Client::~Client(){
 	cleanup();
+	for (auto &conn : pool)
+		BIO_free_all(conn.second.bio);
+	pool.clear();
+	if (this->ctx){
+		SSL_CTX_free(this->ctx);
+		this->ctx = nullptr;
+	}
+}
+
+
+void Client::set_certificates(std::string certfile, std::string certaddr){
+	if (certfile == this->certfile && certaddr == this->certaddr)
+		return;
+
+	this->certfile = certfile;
+	this->certaddr = certaddr;
+
+	// trust store is outdated, it will be loaded again on next https request
+	if (this->ctx){
+		SSL_CTX_free(this->ctx);
+		this->ctx = nullptr;
+	}
+}
+
+
+void Client::set_session_cache(SessionCache *sessions){
+	this->sessions = sessions;
+}
+
+
+void Client::set_timeouts(struct timeouts timeouts){
+	this->timeouts = timeouts;
+}
+
+
+void Client::set_resolver(Resolver *resolver){
+	this->resolver = resolver ? resolver : &this->own_resolver;
+}
+
+
+void Client::set_http_cache(HttpCache *cache){
+	this->cache = cache;
 }
 
 
@@ -39,42 +102,71 @@ void Client::cleanup(){
 		BIO_free_all(this->bio);
 		this->bio = nullptr;
 	}
-	if (this->ctx){
-		SSL_CTX_free(this->ctx);
-		this->ctx = nullptr;
+	// response was not received completely, previous cached version is kept
+	if (this->cache_entry){
+		this->cache->end(this->cache_url, this->cache_entry, this->cache_tmp, false);
+		this->cache_entry = nullptr;
 	}
 }
 
 
-struct url Client::parse_url(std::string url){
-	struct url parsed_url = {false, std::string(), std::string(), std::string(), std::string()};
-	static std::regex re_url(R"(^(https?)://([^/?#:]+)(:[0-9]+)?(.*)$)");
-	std::smatch match;
+struct url Client::parse_url(std::string_view url){
+	struct url parsed_url = {false, std::string(), std::string(), std::string(), std::string(), std::string()};
+	struct url_view parts;
 
-	if (!std::regex_match(url, match, re_url))
+	if (!scan_url(url, parts))
 		return parsed_url;
-	parsed_url.protocol = std::string(match[1]);
-	parsed_url.authority = std::string(match[2]);
-	parsed_url.path = std::string(match[4]);
-	std::string port = std::string(match[3]);
-	if (port.empty()){
-		parsed_url.port = PORT_MAP[parsed_url.protocol];
-		parsed_url.authority += ":" + std::string(parsed_url.port);
-	}
+	auto protocol = PORT_MAP.find(std::string(parts.scheme));
+	if (protocol == PORT_MAP.end())
+		return parsed_url;
+
+	// userinfo is not used for authentication, fragment is never sent to server
+	parsed_url.protocol = protocol->first;
+	parsed_url.port = parts.port.empty() ? protocol->second : std::string(parts.port);
+	parsed_url.authority.reserve(parts.host.size() + 1 + parsed_url.port.size());
+	if (parts.host[0] == '[')
+		parsed_url.host = std::string(parts.host.substr(1, parts.host.size() - 2));
+	else
+		parsed_url.host = std::string(parts.host);
+	parsed_url.authority.append(parts.host).append(":").append(parsed_url.port);
+	parsed_url.path.reserve(1 + parts.path.size() + 1 + parts.query.size());
+	parsed_url.path.append(parts.path.empty() ? std::string_view("/") : parts.path);
+	if (parts.has_query)
+		parsed_url.path.append("?").append(parts.query);
 	parsed_url.valid = true;
 
 	return parsed_url;
 }
 
 
-bool Client::verify_certificate(std::string protocol, std::string authority){
+bool Client::verify_certificate(std::string protocol, int fd){
 	if (protocol != "https"){
-		this->bio = BIO_new_connect(authority.c_str());
+		this->bio = BIO_new_socket(fd, BIO_CLOSE);
+		return true;
+	}
+
+	if (!this->ctx && !init_context())
+		return false;
+
+	// TLS filter on top of socket, whole chain is freed together
+	BIO *ssl = BIO_new_ssl(this->ctx, 1);
+	BIO *socket = ssl ? BIO_new_socket(fd, BIO_CLOSE) : nullptr;
+	if (!socket){
+		BIO_free(ssl);
 		return true;
 	}
+	this->bio = BIO_push(ssl, socket);
+
+	return true;
+}
+
 
+bool Client::init_context(){
 	int verification = 0;
 	this->ctx = SSL_CTX_new(SSLv23_client_method());
+	if (!this->ctx)
+		return false;
+
 	if (certfile.empty() && certaddr.empty()){
 		verification = SSL_CTX_set_default_verify_paths(this->ctx);
 	}
@@ -89,38 +181,73 @@ bool Client::verify_certificate(std::string protocol, std::string authority){
 	}
 
 	if (!verification){
+		SSL_CTX_free(this->ctx);
+		this->ctx = nullptr;
 		return false;
 	}
 
-	this->bio = BIO_new_ssl_connect(this->ctx);
-
 	return true;
 }
 
 
 bool Client::socket_init(struct url _url){
-	if (!verify_certificate(_url.protocol, _url.authority)){
+	// addresses of hosts from url list are usually prefetched by the time they are needed,
+	// lookup is limited only by total timeout
+	std::vector<struct address> addresses;
+	start_phase("resolve", 0);
+	if (!this->resolver->resolve(_url.host, addresses, remaining())){
+		if (remaining() == 0)
+			this->expired = true;
+		else
+			std::cerr << "Error: Can't resolve host '" << _url.host << "'." << std::endl;
+		return false;
+	}
+
+	start_phase("connect", this->timeouts.connect);
+	int fd = happy_connect(addresses, std::stoi(_url.port), remaining());
+	if (fd < 0){
+		if (remaining() == 0)
+			this->expired = true;
+		else
+			std::cerr << "Error: Can't connect to '" << _url.authority << "'." << std::endl;
+		return false;
+	}
+	this->stats.connections++;
+
+	if (!verify_certificate(_url.protocol, fd)){
+		close(fd);
 		std::cerr << "Error: Verification of certificates failed." << std::endl;
 		return false;
 	}
 	if (!this->bio){
+		close(fd);
 		std::cerr << "Error: Socket setup failure." << std::endl;
 		return false;
 	}
-	
+	if (_url.protocol != "https")
+		return true;
+
 	SSL *ssl = nullptr;
-	if (_url.protocol == "https"){
-		BIO_get_ssl(this->bio, &ssl);
-		SSL_set_mode(ssl, SSL_MODE_AUTO_RETRY);
-		BIO_set_conn_hostname(this->bio, _url.authority.c_str());
+	BIO_get_ssl(this->bio, &ssl);
+	SSL_set_mode(ssl, SSL_MODE_AUTO_RETRY);
+	// server name is sent only for names, not for address literals
+	if (!_url.host.empty() && _url.host.find_first_not_of("0123456789.") != std::string::npos && _url.host.find(':') == std::string::npos)
+		SSL_set_tlsext_host_name(ssl, _url.host.c_str());
+
+	// offer previous session with the same host to skip full handshake
+	SSL_SESSION *session = this->sessions ? this->sessions->get(_url.authority) : nullptr;
+	if (session){
+		SSL_set_session(ssl, session);
+		SSL_SESSION_free(session);
 	}
 
-	if (BIO_do_connect(this->bio) <= 0){
-		std::cerr << "Error: Handshake failure." << std::endl;
+	if (!handshake()){
+		if (!this->expired)
+			std::cerr << "Error: Handshake failure." << std::endl;
 		return false;
 	}
 
-	if (ssl && SSL_get_verify_result(ssl) != X509_V_OK){
+	if (SSL_get_verify_result(ssl) != X509_V_OK){
 		std::cerr << "Chyba: nepodařilo se ověřit platnost certifikátu serveru " << _url.authority << std::endl;
 		return false;
 	}
@@ -128,93 +255,379 @@ bool Client::socket_init(struct url _url){
 }
 
 
-std::string Client::get_response_body(std::string response){
-	std::map<std::string, std::string> parsed_response;
-	const char *resp_cstr = response.c_str();
-    const char *head = resp_cstr;
-    const char *tail = resp_cstr;
+void Client::start_phase(const char *phase, int timeout){
+	using clock = std::chrono::steady_clock;
+	this->phase = phase;
+	this->deadline = clock::time_point::max();
+	if (timeout > 0)
+		this->deadline = clock::now() + std::chrono::milliseconds(timeout);
+	if (this->timeouts.total > 0)
+		this->deadline = std::min(this->deadline, this->started + std::chrono::milliseconds(this->timeouts.total));
+}
+
+
+int Client::remaining(){
+	using clock = std::chrono::steady_clock;
+	if (this->deadline == clock::time_point::max())
+		return -1;
+
+	clock::time_point now = clock::now();
+	if (now >= this->deadline)
+		return 0;
+	auto left = std::chrono::duration_cast<std::chrono::milliseconds>(this->deadline - now).count() + 1;
+	return left > INT_MAX ? INT_MAX : static_cast<int>(left);
+}
+
+
+bool Client::wait_io(){
+	int fd = -1;
+	BIO_get_fd(this->bio, &fd);
+	if (fd < 0)
+		return false;
+
+	// TLS layer may need to write while reading (and vice versa), BIO tells which one it waits for
+	struct pollfd ready = {fd, static_cast<short>(BIO_should_write(this->bio) ? POLLOUT : POLLIN), 0};
+	while (true){
+		int timeout = remaining();
+		if (timeout == 0){
+			this->expired = true;
+			return false;
+		}
+		int events = poll(&ready, 1, timeout);
+		if (events > 0)
+			return true;
+		if (events < 0 && errno != EINTR)
+			return false;
+	}
+}
+
+
+bool Client::handshake(){
+	start_phase("handshake", this->timeouts.handshake);
+	auto start = std::chrono::steady_clock::now();
+	while (BIO_do_handshake(this->bio) <= 0){
+		if (!BIO_should_retry(this->bio) || !wait_io())
+			return false;
+	}
+
+	SSL *ssl = nullptr;
+	BIO_get_ssl(this->bio, &ssl);
+	this->stats.handshakes++;
+	this->stats.resumed += ssl && SSL_session_reused(ssl);
+	this->stats.handshake_us += std::chrono::duration_cast<std::chrono::microseconds>(
+		std::chrono::steady_clock::now() - start).count();
+	return true;
+}
+
+
+void Client::store_session(std::string authority){
+	SSL *ssl = nullptr;
+	if (!this->sessions || !this->bio)
+		return;
+
+	BIO_get_ssl(this->bio, &ssl);
+	if (ssl)
+		this->sessions->put(authority, SSL_get1_session(ssl));
+}
+
+
+int Client::read_some(Buffer &data){
+	while (true){
+		char *space = data.space(BUFFER_SIZE);
+		int read = BIO_read(this->bio, space, BUFFER_SIZE);
+		if (read > 0){
+			data.commit(read);
+			return read;
+		}
+		if (!BIO_should_retry(this->bio))
+			return read == 0 ? 0 : -1;
+		if (!wait_io())
+			return -1;
+	}
+}
+
+
+bool Client::deliver(Buffer &data){
+	std::string_view piece = this->parser.body(data);
+	if (piece.empty())
+		return true;
+
+	// compressed piece is decompressed before it is passed on
+	size_t received = piece.size();
+	if (this->decoder.active()){
+		this->decoded.clear();
+		if (!this->decoder.decode(piece, this->decoded))
+			return false;
+		piece = this->decoded.view();
+	}
+
+	if (!piece.empty()){
+		this->consumer(piece);
+		if (this->cache_entry)
+			fwrite(piece.data(), 1, piece.size(), this->cache_entry);
+	}
+	this->delivered += received;
+
+	// delivered body and already processed framing are dropped, so buffer does not grow
+	this->parser.consume(data);
+	return true;
+}
+
+
+bool Client::start_body(struct response &resp){
+	// only bodies of successful responses are streamed, others are reported as usual
+	this->streaming = this->consumer && resp.status_code[0] == '2';
+
+	// successful responses carrying validators are cached for conditional requests
+	if (this->cache && resp.status_code[0] == '2'){
+		struct validators v = {resp.headers["etag"], resp.headers["last-modified"]};
+		if (!v.etag.empty() || !v.last_modified.empty())
+			this->cache_entry = this->cache->begin(this->cache_url, v, this->cache_tmp);
+	}
+
+	// compressed body is decompressed while it is read (streaming) or once it is complete
+	if (!this->decoder.init(resp.headers["content-encoding"])){
+		std::cerr << "Unsupported content encoding '" << resp.headers["content-encoding"] << "'." << std::endl;
+		return false;
+	}
+	return true;
+}
+
+
+bool Client::read_response(Buffer &data, struct response &resp){
+	bool head = false;
+	bool received = false;
+	data.clear();
+	this->parser.reset();
+
+	int status = HTTP_MORE;
+	while (true){
+		status = this->parser.parse(data, resp);
+		if (status == HTTP_ERROR)
+			return false;
+
+		if (!head && this->parser.head_done()){
+			head = true;
+			if (!start_body(resp))
+				return false;
+			// whole body fits in without reallocation, BIO reads straight into its place,
+			// larger bodies grow the buffer as they arrive
+			if (!this->streaming && this->parser.content_length())
+				data.reserve(data.size() + std::min<size_t>(this->parser.content_length(), RESERVE_LIMIT));
+		}
+		if (this->streaming && !deliver(data))
+			return false;
+		if (status == HTTP_DONE)
+			break;
+
+		int read = read_some(data);
+		if (read < 0)
+			return false;
+		// once response started to arrive, only total deadline applies
+		if (read && !received){
+			received = true;
+			start_phase("transfer", 0);
+		}
+		if (!read && this->parser.eof(data, resp) != HTTP_DONE)
+			return false;
+		if (!read)
+			break;
+	}
+
+	if (this->streaming){
+		resp.body = std::string_view();
+		if (!deliver(data))
+			return false;
+	}
+
+	if (!this->decoder.active())
+		return true;
+	if (!this->streaming){
+		this->decoded.clear();
+		this->decoded.reserve(std::min<size_t>(resp.body.size() * 4, RESERVE_LIMIT));
+		if (!this->decoder.decode(resp.body, this->decoded))
+			return false;
+		// decompressed body takes place of received data in caller's buffer
+		std::swap(data, this->decoded);
+		resp.body = data.view();
+	}
+	if (!this->decoder.done()){
+		std::cerr << "Compressed body is incomplete." << std::endl;
+		return false;
+	}
+	return true;
+}
+
+
+std::string_view Client::get_response_body(struct response &resp){
+	if (resp.status_code[0] != '2'){
+		std::cerr << "Return code: " << resp.status_code << std::endl;
+		return std::string_view();
+	}
+
+	this->completed = true;
+	return resp.body;
+}
+
+
+bool Client::take_connection(std::string key){
+	auto conn = pool.find(key);
+	if (conn == pool.end())
+		return false;
 
-    while (*tail != '\r' && *tail != ' ') ++tail;
-    parsed_response["http_v"] = std::string(head, tail);
+	this->bio = conn->second.bio;
+	pool.erase(conn);
+	return true;
+}
 
-    while (*tail != '\r' && *tail == ' ') ++tail;
-    head = tail;
-        
-    while (*tail != '\r' && *tail != ' ') ++tail;
-    parsed_response["status_code"] = std::string(head, tail);
 
-	if (parsed_response["status_code"][0] != '2'){
-		std::cerr << "Return code: " << parsed_response["status_code"] << std::endl;
-		return std::string();
+void Client::keep_connection(std::string key){
+	if (pool.size() >= POOL_SIZE){
+		// make room by closing least recently used connection
+		auto oldest = pool.begin();
+		for (auto conn = pool.begin(); conn != pool.end(); conn++)
+			if (conn->second.last_used < oldest->second.last_used)
+				oldest = conn;
+		BIO_free_all(oldest->second.bio);
+		pool.erase(oldest);
 	}
-    
-	size_t body_start = response.find("\r\n\r\n");
-	body_start = body_start == std::string::npos ? response.find("\n\n") + 2 : body_start + 4;
 
-    return response.substr(body_start);
+	pool[key] = {this->bio, time(nullptr)};
+	this->bio = nullptr;
 }
 
 
-std::string Client::request(std::string url){
-	static unsigned int request_number = 0;
+void Client::evict_idle(){
+	time_t now = time(nullptr);
+	for (auto conn = pool.begin(); conn != pool.end();){
+		if (now - conn->second.last_used >= KEEPALIVE_TIMEOUT){
+			BIO_free_all(conn->second.bio);
+			conn = pool.erase(conn);
+		}
+		else
+			conn++;
+	}
+}
 
+
+bool Client::send_request(std::string &http_request){
+	size_t sent = 0;
+	while (sent < http_request.size()){
+		int written = BIO_write(this->bio, http_request.c_str() + sent, static_cast<int>(http_request.size() - sent));
+		if (written > 0)
+			sent += written;
+		else if (!BIO_should_retry(this->bio) || !wait_io())
+			return false;
+	}
+	return true;
+}
+
+
+std::string_view Client::request(std::string url, Buffer &data, std::function<void(std::string_view)> consumer){
 	// 1. connection init
 	struct url _url = parse_url(url);
+	this->started = std::chrono::steady_clock::now();
+	this->expired = false;
+	start_phase("resolve", 0);
+	this->consumer = consumer;
+	this->streaming = false;
+	this->delivered = 0;
+	this->completed = false;
 
-	if (request_number++) std::cout << "\n";
 	if (!_url.valid){
 		std::cerr << "Invalid url '" << url << "'." << std::endl;
-		cleanup();
-		return std::string();
-	}
-	
-	if (!socket_init(_url)){
-		cleanup();
-		return std::string();
+		return std::string_view();
 	}
+	this->stats.requests++;
+
+	std::string key = _url.protocol + "://" + _url.authority;
+	evict_idle();
 
-	// 2. send request
 	std::string http_request(
 		"GET " + _url.path + " HTTP/1.1\r\n"
 		"Host: " + _url.authority + "\r\n"
-		"Connection: close\r\n"
-		"User-Agent: isa-project/feedreader (FIT-BUT)\r\n\r\n"
+		"Connection: keep-alive\r\n"
+		"User-Agent: isa-project/feedreader (FIT-BUT)\r\n"
+		"Accept-Encoding: " ACCEPT_ENCODING "\r\n"
 	);
 
-	bool sent = false;
-	do {
-		if (BIO_write(this->bio, http_request.c_str(), static_cast<int>(http_request.size())))
-			sent = true;
-	} while (BIO_should_retry(this->bio) && !sent);
+	// cached feeds are requested conditionally, server answers 304 if they did not change
+	struct validators cached;
+	bool conditional = this->cache && this->cache->lookup(url, cached);
+	if (conditional){
+		if (!cached.etag.empty())
+			http_request += "If-None-Match: " + cached.etag + "\r\n";
+		if (!cached.last_modified.empty())
+			http_request += "If-Modified-Since: " + cached.last_modified + "\r\n";
+	}
+	http_request += "\r\n";
+	this->cache_url = url;
+
+	// 2. send request and get response, idle connection from pool may have been closed
+	// by server in the meantime, then request is repeated on a new connection
+	struct response resp;
+	bool reused = take_connection(key);
+	while (true){
+		if (!reused && !socket_init(_url)){
+			cleanup();
+			if (this->expired)
+				std::cerr << "Error: Timeout of " << this->phase << " expired for '" << url << "'." << std::endl;
+			return std::string_view();
+		}
+
+		start_phase("first byte", this->timeouts.first_byte);
+		if (send_request(http_request) && read_response(data, resp))
+			break;
 
-	if (!sent){
 		cleanup();
-		return std::string();
-	}
-
-	// 3. get response
-	std::string http_response;
-	char buffer[BUFFER_SIZE] = {0,};
-	int read = 0;
-	do {
-		bool success = false;
-		do {
-			if ((read = BIO_read(this->bio, buffer, BUFFER_SIZE - 1)) > 0){
-				buffer[read] = 0;
-				http_response += buffer;
-			}
-			if (read >= 0)
-				success = true;
-		} while (BIO_should_retry(this->bio) && !success);
-
-		if (!success){
-			std::cerr << "Error while reading response." << std::endl;
-			cleanup();
-			return std::string();
+		if (this->expired){
+			std::cerr << "Error: Timeout of " << this->phase << " expired for '" << url << "'." << std::endl;
+			return std::string_view();
 		}
-	} while (read);
-	
-	cleanup();
-	return get_response_body(http_response);
+		// request can be repeated only if nothing was passed on from broken connection yet
+		if (reused && !this->delivered){
+			reused = false;
+			continue;
+		}
+		std::cerr << "Error while reading response." << std::endl;
+		return std::string_view();
+	}
+
+	// TLS 1.3 session tickets arrive after handshake, so session is stored once response is read
+	if (_url.protocol == "https")
+		store_session(_url.authority);
+
+	// new version of feed is stored in cache, body of streamed response was stored while it arrived
+	if (this->cache_entry){
+		if (!this->streaming)
+			fwrite(resp.body.data(), 1, resp.body.size(), this->cache_entry);
+		this->cache->end(url, this->cache_entry, this->cache_tmp, true);
+		this->cache_entry = nullptr;
+	}
+
+	if (resp.keep_alive)
+		keep_connection(key);
+	else
+		cleanup();
+
+	if (conditional && resp.status_code == "304"){
+		// cached copy is still up to date
+		if (this->cache->read(url, data, consumer)){
+			this->completed = true;
+			return consumer ? std::string_view() : data.view();
+		}
+		std::cerr << "Can't read cached copy of '" << url << "'." << std::endl;
+		return std::string_view();
+	}
+	return get_response_body(resp);
 }
 
+
+bool Client::request_completed(){
+	return this->completed;
+}
+
+
+struct client_stats Client::get_stats(){
+	return this->stats;
+}
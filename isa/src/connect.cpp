@@ -0,0 +1,125 @@
+/*
+ * connect.cpp
+ *
+ * Connecting to hosts with multiple addresses by Happy Eyeballs algorithm (RFC 8305).
+ *
+ * Project: Reader of news feed in format Atom & RSS with support of TLS
+ * Author: Matus Remen (xremen01@stud.fit.vutbr.cz)
+ * Date: 17.10.2026
+ */
+
+#include <chrono>
+#include <climits>
+#include <algorithm>
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include "../include/connect.hpp"
+
+
+std::vector<struct address> interleave_addresses(const std::vector<struct address> &addresses){
+	std::vector<struct address> first, second, ordered;
+	if (addresses.empty())
+		return ordered;
+
+	int preferred = addresses[0].addr.ss_family;
+	for (const struct address &addr : addresses)
+		(addr.addr.ss_family == preferred ? first : second).push_back(addr);
+
+	for (size_t i = 0; i < first.size() || i < second.size(); i++){
+		if (i < first.size())
+			ordered.push_back(first[i]);
+		if (i < second.size())
+			ordered.push_back(second[i]);
+	}
+	return ordered;
+}
+
+
+// start non-blocking connection attempt, returns socket or -1 if attempt failed immediately,
+// connected is set if connection was established right away
+static int start_attempt(struct address addr, unsigned short port, bool &connected){
+	if (addr.addr.ss_family == AF_INET)
+		((struct sockaddr_in *)&addr.addr)->sin_port = htons(port);
+	else
+		((struct sockaddr_in6 *)&addr.addr)->sin6_port = htons(port);
+
+	int fd = socket(addr.addr.ss_family, SOCK_STREAM, 0);
+	if (fd < 0)
+		return -1;
+	fcntl(fd, F_SETFD, FD_CLOEXEC);
+	fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+	connected = connect(fd, (struct sockaddr *)&addr.addr, addr.length) == 0;
+	if (!connected && errno != EINPROGRESS){
+		close(fd);
+		return -1;
+	}
+	return fd;
+}
+
+
+int happy_connect(const std::vector<struct address> &addresses, unsigned short port, int timeout){
+	using clock = std::chrono::steady_clock;
+	std::vector<struct address> ordered = interleave_addresses(addresses);
+	std::vector<struct pollfd> attempts;
+	size_t next = 0;
+	int winner = -1;
+
+	clock::time_point deadline = timeout < 0 ? clock::time_point::max() : clock::now() + std::chrono::milliseconds(timeout);
+	clock::time_point next_attempt = clock::now();
+
+	while (winner < 0){
+		clock::time_point now = clock::now();
+		if (now >= deadline)
+			break;
+
+		// next attempt starts after delay, or right away when no other attempt is running
+		if (next < ordered.size() && (now >= next_attempt || attempts.empty())){
+			bool connected = false;
+			int fd = start_attempt(ordered[next++], port, connected);
+			if (connected){
+				winner = fd;
+				break;
+			}
+			if (fd >= 0){
+				attempts.push_back({fd, POLLOUT, 0});
+				next_attempt = now + std::chrono::milliseconds(CONNECT_ATTEMPT_DELAY);
+			}
+			continue;
+		}
+		if (attempts.empty())
+			break;
+
+		clock::time_point until = next < ordered.size() ? std::min(next_attempt, deadline) : deadline;
+		int wait = -1;
+		if (until != clock::time_point::max())
+			wait = std::min<long long>(std::chrono::duration_cast<std::chrono::milliseconds>(until - now).count() + 1, INT_MAX);
+		if (poll(attempts.data(), attempts.size(), wait) < 0 && errno != EINTR)
+			break;
+
+		for (size_t i = 0; i < attempts.size(); ){
+			if (!attempts[i].revents){
+				i++;
+				continue;
+			}
+			int error = 0;
+			socklen_t length = sizeof(error);
+			if (getsockopt(attempts[i].fd, SOL_SOCKET, SO_ERROR, &error, &length) == 0 && error == 0){
+				winner = attempts[i].fd;
+				attempts.erase(attempts.begin() + i);
+				break;
+			}
+			// failed attempt makes room for next address immediately
+			close(attempts[i].fd);
+			attempts.erase(attempts.begin() + i);
+			next_attempt = clock::now();
+		}
+	}
+
+	for (struct pollfd &attempt : attempts)
+		close(attempt.fd);
+	return winner;
+}
@@ -0,0 +1,258 @@
+/*
+ * daemon.cpp
+ *
+ * Long running mode polling feeds and answering queries on Unix socket.
+ *
+ * Project: Reader of news feed in format Atom & RSS with support of TLS
+ * Author: Matus Remen (xremen01@stud.fit.vutbr.cz)
+ * Date: 17.10.2026
+ */
+
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <iostream>
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "../include/daemon.hpp"
+#include "../include/parser.hpp"
+
+
+volatile sig_atomic_t Daemon::stopping = 0;
+
+
+Daemon::Daemon(Fetcher &fetcher, PollStore &poll, Sink &sink, std::string socket_path)
+	: fetcher(fetcher), poll(poll), sink(sink){
+	this->socket_path = socket_path;
+	this->listener = -1;
+	this->rounds = 0;
+}
+
+
+Daemon::~Daemon(){
+	if (this->listener >= 0){
+		close(this->listener);
+		unlink(this->socket_path.c_str());
+	}
+}
+
+
+void Daemon::set_poll_file(std::string path){
+	this->poll_file = path;
+}
+
+
+void Daemon::on_signal(int){
+	stopping = 1;
+}
+
+
+bool Daemon::listen_socket(){
+	struct sockaddr_un addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	if (this->socket_path.empty() || this->socket_path.size() >= sizeof(addr.sun_path))
+		return false;
+	memcpy(addr.sun_path, this->socket_path.c_str(), this->socket_path.size());
+
+	// socket left behind by daemon which did not exit cleanly, other files are not touched,
+	// socket of daemon which is still running answers and is kept
+	struct stat st;
+	if (!lstat(this->socket_path.c_str(), &st) && S_ISSOCK(st.st_mode)){
+		int probe = socket(AF_UNIX, SOCK_STREAM, 0);
+		bool running = probe >= 0 && !connect(probe, (struct sockaddr *) &addr, sizeof(addr));
+		if (probe >= 0)
+			close(probe);
+		if (running){
+			std::cerr << "Socket '" << this->socket_path << "' is used by another daemon." << std::endl;
+			return false;
+		}
+		unlink(this->socket_path.c_str());
+	}
+
+	this->listener = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (this->listener < 0)
+		return false;
+	if (bind(this->listener, (struct sockaddr *) &addr, sizeof(addr)) || listen(this->listener, SOMAXCONN)){
+		close(this->listener);
+		this->listener = -1;
+		return false;
+	}
+	return true;
+}
+
+
+void Daemon::serve(){
+	struct pollfd waiting = {this->listener, POLLIN, 0};
+	while (!stopping){
+		if (::poll(&waiting, 1, DAEMON_TICK) <= 0)
+			continue;
+		int fd = accept(this->listener, nullptr, nullptr);
+		if (fd < 0)
+			continue;
+		answer(fd);
+		close(fd);
+	}
+}
+
+
+bool Daemon::wait_client(int fd, short events, std::chrono::steady_clock::time_point deadline){
+	auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+	struct pollfd waiting = {fd, events, 0};
+	return left > 0 && ::poll(&waiting, 1, static_cast<int>(left)) > 0;
+}
+
+
+void Daemon::answer(int fd){
+	// slow client can not block others for long, whole exchange has one deadline
+	auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(DAEMON_TIMEOUT);
+	fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+	std::string request;
+	char buffer[512];
+	while (request.find('\n') == std::string::npos && request.size() < DAEMON_REQUEST){
+		ssize_t length = read(fd, buffer, sizeof(buffer));
+		if (length < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) && wait_client(fd, POLLIN, deadline))
+			continue;
+		if (length <= 0)
+			break;
+		request.append(buffer, length);
+	}
+	size_t end = request.find('\n');
+	if (end == std::string::npos && request.size() >= DAEMON_REQUEST)
+		return;
+	request.resize(end == std::string::npos ? request.size() : end);
+	if (!request.empty() && request.back() == '\r')
+		request.pop_back();
+
+	std::ostringstream out;
+	handle(request, out);
+	std::string response = out.str();
+	for (size_t sent = 0; sent < response.size();){
+		ssize_t length = write(fd, response.data() + sent, response.size() - sent);
+		if (length < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) && wait_client(fd, POLLOUT, deadline))
+			continue;
+		if (length <= 0)
+			return;
+		sent += length;
+	}
+}
+
+
+void Daemon::handle(std::string_view request, std::ostream &out){
+	size_t space = request.find(' ');
+	std::string_view command = request.substr(0, space);
+	std::string_view argument = space == std::string_view::npos ? std::string_view() : request.substr(space + 1);
+
+	if (command == "FEEDS" && argument.empty())
+		this->index.list(out);
+	else if (command == "ENTRIES" && !argument.empty()){
+		if (!this->index.entries(out, this->sink, argument))
+			out << "ERROR unknown feed\n";
+	}
+	else if (command == "LATEST"){
+		size_t count = DAEMON_LATEST;
+		if (!argument.empty()){
+			std::string number(argument);
+			char *rest = nullptr;
+			count = strtoul(number.c_str(), &rest, 10);
+			if (*rest || number[0] == '-'){
+				out << "ERROR invalid count\n";
+				return;
+			}
+		}
+		this->index.latest(out, this->sink, count);
+	}
+	else if (command == "STATUS" && argument.empty())
+		out << "rounds " << this->rounds << " feeds " << this->index.feed_count() << " entries "
+			<< this->index.entry_count() << "\n";
+	else
+		out << "ERROR unknown request\n";
+}
+
+
+bool Daemon::update(std::string url, std::string_view body){
+	// messages go to index, the stream gets nothing
+	std::ostringstream unused;
+	IndexSink collected(time(nullptr));
+	Parser parser = Parser(body, false, false, false, unused);
+	parser.set_sink(&collected, url);
+	parser.set_poll_store(&this->poll, url);
+	if (!parser.parse_feed())
+		return false;
+	// feed which could not be read keeps entries of its last successful parse
+	collected.commit(this->index, url);
+	return true;
+}
+
+
+void Daemon::round(const std::vector<std::string_view> &urls){
+	time_t now = time(nullptr);
+	std::vector<std::string_view> due;
+	for (std::string_view url : urls)
+		if (this->poll.due(url, now))
+			due.push_back(url);
+	if (due.empty())
+		return;
+
+	// addresses of hosts may change between rounds, everything else of clients is kept
+	this->fetcher.refresh();
+	this->fetcher.fetch(due, [&](size_t idx, Buffer &, std::string_view body){
+		if (!body.empty())
+			update(std::string(due[idx]), body);
+	});
+}
+
+
+time_t Daemon::next_round(const std::vector<std::string_view> &urls, time_t started){
+	// feed failing to download stays due, it is tried again no sooner than after DAEMON_ROUND,
+	// feed which was never read successfully has no due time and is due right away
+	time_t next = 0;
+	bool found = false;
+	for (std::string_view url : urls){
+		time_t due = this->poll.due_time(url);
+		due = due ? due : started;
+		if (!found || due < next)
+			next = due;
+		found = true;
+	}
+	return std::max(next, started + DAEMON_ROUND);
+}
+
+
+bool Daemon::run(const std::vector<std::string_view> &urls){
+	if (!listen_socket())
+		return false;
+
+	stopping = 0;
+	struct sigaction action;
+	memset(&action, 0, sizeof(action));
+	action.sa_handler = on_signal;
+	sigaction(SIGINT, &action, nullptr);
+	sigaction(SIGTERM, &action, nullptr);
+	// client closing connection before reading response must not end the daemon
+	signal(SIGPIPE, SIG_IGN);
+
+	std::thread server(&Daemon::serve, this);
+	while (!stopping){
+		time_t started = time(nullptr);
+		round(urls);
+		this->rounds++;
+		if (!this->poll_file.empty() && !this->poll.save(this->poll_file))
+			std::cerr << "Can't save update history to '" << this->poll_file << "'." << std::endl;
+
+		time_t next = next_round(urls, started);
+		while (!stopping && time(nullptr) < next)
+			std::this_thread::sleep_for(std::chrono::milliseconds(DAEMON_TICK));
+	}
+	server.join();
+	return true;
+}
@@ -0,0 +1,243 @@
+/*
+ * decoder.cpp
+ *
+ * Streaming decompression of response bodies (Content-Encoding gzip, deflate, br).
+ *
+ * Project: Reader of news feed in format Atom & RSS with support of TLS
+ * Author: Matus Remen (xremen01@stud.fit.vutbr.cz)
+ * Date: 17.10.2026
+ */
+
+#include <cstring>
+#include <iostream>
+#include "../include/decoder.hpp"
+
+// minimal free space for decompressed data appended to output buffer
+#define DECODE_CHUNK 16384
+
+
+Decoder::Decoder(){
+	this->type = _DEC_NONE;
+	this->finished = false;
+	this->raw = false;
+	this->detected = false;
+	this->empty = true;
+	this->produced = 0;
+	this->zlib_ready = false;
+	memset(&this->zlib, 0, sizeof(this->zlib));
+#ifdef HAVE_BROTLI
+	this->brotli = nullptr;
+#endif
+}
+
+
+Decoder::~Decoder(){
+	reset();
+}
+
+
+void Decoder::reset(){
+	if (this->zlib_ready){
+		inflateEnd(&this->zlib);
+		this->zlib_ready = false;
+	}
+#ifdef HAVE_BROTLI
+	if (this->brotli){
+		BrotliDecoderDestroyInstance(this->brotli);
+		this->brotli = nullptr;
+	}
+#endif
+	this->type = _DEC_NONE;
+	this->finished = false;
+	this->raw = false;
+	this->detected = false;
+	this->head.clear();
+	this->empty = true;
+	this->produced = 0;
+}
+
+
+bool Decoder::count(size_t n){
+	this->produced += n;
+	if (this->produced <= DECODE_LIMIT)
+		return true;
+	std::cerr << "Decompressed body is larger than " << DECODE_LIMIT << " bytes." << std::endl;
+	return false;
+}
+
+
+bool Decoder::init(std::string encoding){
+	reset();
+
+	// list of codings, identity does not change anything
+	std::string coding;
+	size_t start = 0;
+	while (start <= encoding.size()){
+		size_t end = encoding.find(',', start);
+		if (end == std::string::npos)
+			end = encoding.size();
+
+		std::string token = encoding.substr(start, end - start);
+		size_t first = token.find_first_not_of(" \t");
+		size_t last = token.find_last_not_of(" \t");
+		token = first == std::string::npos ? std::string() : token.substr(first, last - first + 1);
+		for (char &c : token)
+			c = static_cast<char>(tolower(c));
+
+		if (!token.empty() && token != "identity"){
+			// stacked codings are not supported
+			if (!coding.empty())
+				return false;
+			coding = token;
+		}
+		start = end + 1;
+	}
+
+	if (coding.empty())
+		return true;
+
+	if (coding == "gzip" || coding == "x-gzip" || coding == "deflate"){
+		// window bits 15 + 32 detect gzip and zlib wrapper automatically
+		memset(&this->zlib, 0, sizeof(this->zlib));
+		if (inflateInit2(&this->zlib, 15 + 32) != Z_OK)
+			return false;
+		this->zlib_ready = true;
+		this->type = _DEC_ZLIB;
+		return true;
+	}
+#ifdef HAVE_BROTLI
+	if (coding == "br"){
+		this->brotli = BrotliDecoderCreateInstance(nullptr, nullptr, nullptr);
+		if (!this->brotli)
+			return false;
+		this->type = _DEC_BROTLI;
+		return true;
+	}
+#endif
+	return false;
+}
+
+
+bool Decoder::active(){
+	return this->type != _DEC_NONE;
+}
+
+
+bool Decoder::inflate_data(std::string_view in, Buffer &out){
+	// header may be split over pieces, all of them are needed if it turns out to be raw deflate
+	if (!this->detected)
+		this->head.append(in);
+	this->zlib.next_in = (Bytef *) in.data();
+	this->zlib.avail_in = static_cast<uInt>(in.size());
+
+	while (this->zlib.avail_in){
+		// concatenated gzip members are decoded one after another
+		if (this->finished){
+			inflateReset(&this->zlib);
+			this->finished = false;
+		}
+
+		char *space = out.space(DECODE_CHUNK);
+		this->zlib.next_out = (Bytef *) space;
+		this->zlib.avail_out = DECODE_CHUNK;
+
+		int status = inflate(&this->zlib, Z_NO_FLUSH);
+		out.commit(DECODE_CHUNK - this->zlib.avail_out);
+		if (!count(DECODE_CHUNK - this->zlib.avail_out))
+			return false;
+
+		if (status == Z_DATA_ERROR && !this->detected){
+			// some servers send deflate without zlib wrapper, start again as raw deflate
+			inflateEnd(&this->zlib);
+			memset(&this->zlib, 0, sizeof(this->zlib));
+			this->zlib_ready = false;
+			if (inflateInit2(&this->zlib, -15) != Z_OK)
+				return false;
+			this->zlib_ready = true;
+			this->raw = true;
+			this->detected = true;
+			this->zlib.next_in = (Bytef *) this->head.data();
+			this->zlib.avail_in = static_cast<uInt>(this->head.size());
+			continue;
+		}
+		if (this->zlib.total_out && !this->detected){
+			this->detected = true;
+			this->head.clear();
+		}
+		if (status == Z_STREAM_END){
+			this->finished = true;
+			// garbage behind raw deflate stream can not be another member
+			if (this->raw)
+				return true;
+			continue;
+		}
+		if (status != Z_OK && status != Z_BUF_ERROR)
+			return false;
+	}
+
+	// flush output which did not fit in
+	while (!this->finished){
+		char *space = out.space(DECODE_CHUNK);
+		this->zlib.next_out = (Bytef *) space;
+		this->zlib.avail_out = DECODE_CHUNK;
+		int status = inflate(&this->zlib, Z_NO_FLUSH);
+		out.commit(DECODE_CHUNK - this->zlib.avail_out);
+		if (!count(DECODE_CHUNK - this->zlib.avail_out))
+			return false;
+		if (status == Z_STREAM_END)
+			this->finished = true;
+		else if (status == Z_BUF_ERROR || this->zlib.avail_out)
+			break;
+		else if (status != Z_OK)
+			return false;
+	}
+	return true;
+}
+
+
+#ifdef HAVE_BROTLI
+bool Decoder::brotli_data(std::string_view in, Buffer &out){
+	const uint8_t *next_in = (const uint8_t *) in.data();
+	size_t avail_in = in.size();
+
+	while (true){
+		uint8_t *next_out = (uint8_t *) out.space(DECODE_CHUNK);
+		size_t avail_out = DECODE_CHUNK;
+		BrotliDecoderResult result = BrotliDecoderDecompressStream(
+			this->brotli, &avail_in, &next_in, &avail_out, &next_out, nullptr);
+		out.commit(DECODE_CHUNK - avail_out);
+		if (!count(DECODE_CHUNK - avail_out))
+			return false;
+
+		if (result == BROTLI_DECODER_RESULT_SUCCESS){
+			this->finished = true;
+			return true;
+		}
+		if (result == BROTLI_DECODER_RESULT_NEEDS_MORE_INPUT)
+			return true;
+		if (result == BROTLI_DECODER_RESULT_ERROR)
+			return false;
+	}
+}
+#endif
+
+
+bool Decoder::decode(std::string_view in, Buffer &out){
+	if (!in.empty())
+		this->empty = false;
+	switch (this->type){
+		case _DEC_ZLIB:
+			return inflate_data(in, out);
+#ifdef HAVE_BROTLI
+		case _DEC_BROTLI:
+			return brotli_data(in, out);
+#endif
+		default:
+			return false;
+	}
+}
+
+
+bool Decoder::done(){
+	return this->type == _DEC_NONE || this->finished || this->empty;
+}
@@ -0,0 +1,166 @@
+/*
+ * feedlist.cpp
+ *
+ * List of feed urls loaded from feedfile.
+ *
+ * Project: Reader of news feed in format Atom & RSS with support of TLS
+ * Author: Matus Remen (xremen01@stud.fit.vutbr.cz)
+ * Date: 17.10.2026
+ */
+
+#include <thread>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <unordered_set>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "../include/feedlist.hpp"
+#include "../include/url.hpp"
+
+
+FeedList::FeedList(){
+	this->map = nullptr;
+	this->size = 0;
+}
+
+
+FeedList::~FeedList(){
+	if (this->map)
+		munmap(this->map, this->size);
+}
+
+
+bool FeedList::valid(std::string_view url){
+	// schemes of Client::PORT_MAP
+	struct url_view parts;
+	return scan_url(url, parts) && (parts.scheme == "http" || parts.scheme == "https");
+}
+
+
+void FeedList::index(const char *data, size_t size){
+	const char *end = data + size;
+	while (data < end){
+		const char *newline = static_cast<const char *>(memchr(data, '\n', end - data));
+		const char *line_end = newline ? newline : end;
+		// file written on Windows
+		size_t length = line_end - data;
+		if (length && data[length - 1] == '\r')
+			length--;
+		if (length && data[0] != '#')
+			this->lines.push_back(std::string_view(data, length));
+		data = newline ? newline + 1 : end;
+	}
+}
+
+
+void FeedList::validate(unsigned int threads){
+	size_t count = this->lines.size();
+	std::vector<char> ok(count);
+	auto check = [&](size_t begin, size_t end){
+		for (size_t i = begin; i < end; i++)
+			ok[i] = valid(this->lines[i]);
+	};
+
+	if (!threads)
+		threads = std::max(1u, std::thread::hardware_concurrency());
+	size_t chunks = std::min<size_t>(threads, (count + FEEDLIST_CHUNK - 1) / FEEDLIST_CHUNK);
+	if (chunks <= 1)
+		check(0, count);
+	else {
+		// last chunk is checked by calling thread
+		std::vector<std::thread> workers;
+		size_t chunk = (count + chunks - 1) / chunks;
+		for (size_t begin = 0; begin + chunk < count; begin += chunk)
+			workers.emplace_back(check, begin, begin + chunk);
+		check(workers.size() * chunk, count);
+		for (std::thread &worker : workers)
+			worker.join();
+	}
+
+	// first occurrence of url is kept, invalid urls are reported in order of lines
+	std::unordered_set<std::string_view> unique;
+	unique.reserve(count);
+	this->list.clear();
+	this->list.reserve(count);
+	for (size_t i = 0; i < count; i++){
+		if (!ok[i])
+			std::cerr << "Invalid url '" << this->lines[i] << "'." << std::endl;
+		else if (unique.insert(this->lines[i]).second)
+			this->list.push_back(this->lines[i]);
+	}
+}
+
+
+void FeedList::set_url(std::string url, unsigned int threads){
+	this->single = url;
+	this->lines.assign(1, this->single);
+	validate(threads);
+}
+
+
+bool FeedList::read_all(int fd){
+	char buffer[65536];
+	this->content.clear();
+	while (true){
+		ssize_t length = read(fd, buffer, sizeof(buffer));
+		if (length < 0 && errno == EINTR)
+			continue;
+		if (length < 0)
+			return false;
+		if (!length)
+			return true;
+		this->content.append(buffer, length);
+	}
+}
+
+
+bool FeedList::load(std::string path, unsigned int threads){
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+		return false;
+	struct stat info;
+	if (fstat(fd, &info) < 0){
+		close(fd);
+		return false;
+	}
+
+	// size of pipe is not known, it is read until end
+	if (!S_ISREG(info.st_mode)){
+		bool ok = read_all(fd);
+		close(fd);
+		if (!ok)
+			return false;
+		this->lines.clear();
+		index(this->content.data(), this->content.size());
+		validate(threads);
+		return true;
+	}
+
+	// empty file can not be mapped, it has no urls
+	this->size = static_cast<size_t>(info.st_size);
+	if (this->size){
+		void *data = mmap(nullptr, this->size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (data == MAP_FAILED){
+			close(fd);
+			this->size = 0;
+			return false;
+		}
+		this->map = static_cast<char *>(data);
+		posix_madvise(data, this->size, POSIX_MADV_SEQUENTIAL);
+	}
+	close(fd);
+
+	this->lines.clear();
+	index(this->map, this->size);
+	validate(threads);
+	return true;
+}
+
+
+const std::vector<std::string_view> &FeedList::urls(){
+	return this->list;
+}
@@ -7,38 +7,32 @@
  */
 
 
-#include <fstream>
+#include <unistd.h>
 #include "../include/arguments.hpp"
-#include "../include/client.hpp"
+#include "../include/daemon.hpp"
+#include "../include/feedlist.hpp"
+#include "../include/fetcher.hpp"
 #include "../include/parser.hpp"
+#include "../include/pipeline.hpp"
+#include "../include/sink.hpp"
+#include "../include/stream.hpp"
+#include "../include/output.hpp"
 
 
 // Recognize type of url input (single url / file with urls)
-// return list of urls
-std::vector<std::string> get_urls(Arguments args){
-	std::vector<std::string> url_list;
-	std::string str = args.get_url();
-	if (!str.empty()){
-		url_list.push_back(str);
-		return url_list;
+// fill list of valid unique urls
+bool get_urls(Arguments &args, FeedList &list){
+	std::string url = args.get_url();
+	if (!url.empty()){
+		list.set_url(url);
+		return true;
 	}
 
-	std::ifstream file(args.get_url_file());
-	if (!file.is_open()){
+	if (!list.load(args.get_url_file())){
 		std::cerr << "Can't open file with urls" << std::endl;
-		return url_list;
+		return false;
 	}
-
-	while (getline(file, str)){
-		if (str.empty())
-			continue;
-		else if (str[0] == '#')
-			continue;
-		url_list.push_back(str);
-	}
-	file.close();
-
-	return url_list;
+	return true;
 }
 
 
@@ -50,20 +44,126 @@ int main(int argc, char **argv){
 		return 1;
 	}
 
-	std::vector<std::string> urls = get_urls(args);
+	FeedList list;
+	if (!get_urls(args, list))
+		return 1;
+
+	// feeds checked recently which are not expected to have changed yet are skipped,
+	// missing file is not an error
+	PollStore poll;
+	std::vector<std::string_view> due;
+	if (!args.get_poll_file().empty()){
+		poll.load(args.get_poll_file());
+		time_t now = time(nullptr);
+		for (std::string_view url : list.urls())
+			if (poll.due(url, now))
+				due.push_back(url);
+	}
+	const std::vector<std::string_view> &urls = args.get_poll_file().empty() ? list.urls() : due;
+
+	// TLS sessions from previous runs, missing file is not an error
+	SessionCache sessions;
+	if (!args.get_session_file().empty())
+		sessions.load(args.get_session_file());
+
+	// setup network clients
+	Fetcher fetcher = Fetcher(args.get_cert_file(), args.get_certaddr(), args.get_jobs());
+	fetcher.set_session_cache(&sessions);
+	fetcher.set_timeouts(args.get_timeouts());
+	fetcher.set_host_limits(args.get_host_limits());
+
+	// feeds cached by previous runs are downloaded only if they changed
+	HttpCache cache = HttpCache(args.get_cache_dir());
+	if (!args.get_cache_dir().empty()){
+		if (cache.init())
+			fetcher.set_http_cache(&cache);
+		else
+			std::cerr << "Can't use cache directory '" << args.get_cache_dir() << "'." << std::endl;
+	}
+
+	// entries printed by previous runs are skipped with --new-only
+	SeenStore seen;
+	if (args.new_only() && !seen.open(args.get_seen_file())){
+		std::cerr << "Can't open store of seen entries '" << args.get_seen_file() << "'." << std::endl;
+		return 1;
+	}
+
+	// libxml2 has to be initialized before it is used from multiple threads
+	xmlInitParser();
+
+	// messages are formatted by sink and written through large buffer, without flush per line
+	char filter = (args.ts() ? _TS_OPT : 0) | (args.au() ? _AU_OPT : 0) | (args.ref() ? _REF_OPT : 0);
+	std::unique_ptr<Sink> sink = Sink::create(args.get_format(), filter);
+
+	// daemon polls all feeds of the list by itself, entries are sent to its clients in output format
+	if (args.daemon()){
+		Daemon daemon = Daemon(fetcher, poll, *sink, args.get_daemon_socket());
+		daemon.set_poll_file(args.get_poll_file());
+		if (!daemon.run(list.urls())){
+			std::cerr << "Can't listen on socket '" << args.get_daemon_socket() << "'." << std::endl;
+			return 1;
+		}
+		if (!args.get_session_file().empty() && !sessions.save(args.get_session_file()))
+			std::cerr << "Can't save TLS sessions to '" << args.get_session_file() << "'." << std::endl;
+		xmlCleanupParser();
+		return 0;
+	}
 
-	// setup network client
-	Client client = Client(args.get_cert_file(), args.get_certaddr());
+	Output output = Output(STDOUT_FILENO, args.get_flush_policy(), args.get_flush_threshold());
+	sink->header(output.stream());
 
-	// loop through feed sources and print their messages
-	for (std::string &url : urls){
-		std::string response = client.request(url);
+	// parse whole received feed
+	auto parse = [&](size_t idx, std::string_view response, std::ostream &out){
+		if (idx) sink->separator(out);
 
 		if (!response.empty()){
-			Parser parser = Parser(response, args.ts(), args.au(), args.ref());
+			Parser parser = Parser(response, args.ts(), args.au(), args.ref(), out);
+			parser.set_sink(sink.get(), std::string(urls[idx]));
+			if (args.new_only())
+				parser.set_seen_store(&seen, std::string(urls[idx]));
+			if (!args.get_poll_file().empty())
+				parser.set_poll_store(&poll, std::string(urls[idx]));
 			parser.parse_feed();
 		}
+	};
+
+	// fetch feed sources and print their messages in order of the list
+	if (args.stream()){
+		fetcher.stream(urls, [&](size_t idx, Client &client, std::ostream &out){
+			if (idx) sink->separator(out);
+
+			Buffer data;
+			StreamParser parser = StreamParser(args.ts(), args.au(), args.ref(), out);
+			parser.set_sink(sink.get(), std::string(urls[idx]));
+			if (args.new_only())
+				parser.set_seen_store(&seen, std::string(urls[idx]));
+			if (!args.get_poll_file().empty())
+				parser.set_poll_store(&poll, std::string(urls[idx]));
+			client.request(std::string(urls[idx]), data, [&](std::string_view piece){ parser.feed(piece); });
+			parser.finish(client.request_completed());
+		}, output);
+	}
+	else if (args.get_jobs() > 1 || args.get_parsers() > 1){
+		// feeds are parsed by pool of threads while others are still being fetched
+		Pipeline pipeline = Pipeline(fetcher, args.get_parsers());
+		pipeline.run(urls, parse, output);
+		if (args.stats())
+			pipeline.print_stats(std::cerr);
 	}
+	else {
+		fetcher.run(urls, [&](size_t idx, std::string_view response){
+			parse(idx, response, output.stream());
+			output.feed_done();
+		});
+	}
+	output.flush();
+
+	if (!args.get_session_file().empty() && !sessions.save(args.get_session_file()))
+		std::cerr << "Can't save TLS sessions to '" << args.get_session_file() << "'." << std::endl;
+	if (!args.get_poll_file().empty() && !poll.save(args.get_poll_file()))
+		std::cerr << "Can't save update history to '" << args.get_poll_file() << "'." << std::endl;
+
+	xmlCleanupParser();
 
 	return 0;
 }
@@ -0,0 +1,287 @@
+/*
+ * fetcher.cpp
+ *
+ * Concurrent fetching of multiple feeds with ordered delivery of responses.
+ *
+ * Project: Reader of news feed in format Atom & RSS with support of TLS
+ * Author: Matus Remen (xremen01@stud.fit.vutbr.cz)
+ * Date: 17.10.2026
+ */
+
+#include <ctime>
+#include <thread>
+#include <algorithm>
+#include <sstream>
+#include <iostream>
+#include "../include/fetcher.hpp"
+#include "../include/url.hpp"
+
+
+Fetcher::Fetcher(std::string certfile, std::string certaddr, unsigned int jobs){
+	this->certfile = certfile;
+	this->certaddr = certaddr;
+	this->jobs = jobs ? jobs : 1;
+	this->sessions = nullptr;
+	this->cache = nullptr;
+}
+
+
+Fetcher::~Fetcher(){}
+
+
+void Fetcher::set_session_cache(SessionCache *sessions){
+	this->sessions = sessions;
+}
+
+
+void Fetcher::set_http_cache(HttpCache *cache){
+	this->cache = cache;
+}
+
+
+void Fetcher::set_timeouts(struct timeouts timeouts){
+	this->timeouts = timeouts;
+}
+
+
+void Fetcher::set_host_limits(struct host_limits limits){
+	scheduler.set_limits(limits);
+}
+
+
+void Fetcher::setup(Client &client){
+	client.set_session_cache(sessions);
+	client.set_resolver(&resolver);
+	client.set_http_cache(cache);
+	client.set_timeouts(timeouts);
+}
+
+
+std::unique_ptr<Client> Fetcher::acquire(){
+	std::unique_ptr<Client> client;
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		if (!clients.empty()){
+			client = std::move(clients.back());
+			clients.pop_back();
+		}
+	}
+	if (!client)
+		client = std::make_unique<Client>(certfile, certaddr);
+	setup(*client);
+	return client;
+}
+
+
+void Fetcher::release(std::unique_ptr<Client> client){
+	std::lock_guard<std::mutex> guard(lock);
+	clients.push_back(std::move(client));
+}
+
+
+void Fetcher::refresh(){
+	resolver.forget();
+}
+
+
+struct client_stats Fetcher::get_client_stats(){
+	struct client_stats total;
+	std::lock_guard<std::mutex> guard(lock);
+	for (std::unique_ptr<Client> &client : clients){
+		struct client_stats stats = client->get_stats();
+		total.requests += stats.requests;
+		total.connections += stats.connections;
+		total.handshakes += stats.handshakes;
+		total.resumed += stats.resumed;
+		total.handshake_us += stats.handshake_us;
+	}
+	return total;
+}
+
+
+void Fetcher::prefetch(const std::vector<std::string_view> &urls){
+	struct url_view parts;
+	for (std::string_view url : urls){
+		if (!scan_url(url, parts))
+			continue;
+		if (parts.host[0] == '[')
+			resolver.prefetch(std::string(parts.host.substr(1, parts.host.size() - 2)));
+		else
+			resolver.prefetch(std::string(parts.host));
+	}
+}
+
+
+void Fetcher::plan(const std::vector<std::string_view> &urls, size_t window){
+	// feed which changed recently is likely to change again, it goes before older ones,
+	// feed without cached response has nothing to compare and goes first
+	// ages are coarse classes (log2 of hours), within a class hosts are served in turns
+	std::vector<long> priorities;
+	if (cache){
+		time_t now = time(nullptr);
+		priorities.resize(urls.size());
+		for (size_t idx = 0; idx < urls.size(); idx++){
+			time_t changed = cache->changed(std::string(urls[idx]));
+			if (!changed)
+				continue;
+			long hours = static_cast<long>(std::max<time_t>(0, now - changed) / 3600);
+			long age = 1;
+			while (hours && age < FETCH_CLASSES - 1){
+				hours >>= 1;
+				age++;
+			}
+			priorities[idx] = age;
+		}
+	}
+	scheduler.start(urls, priorities, window);
+}
+
+
+void Fetcher::worker(std::function<void(Client &, size_t)> task){
+	std::unique_ptr<Client> client = acquire();
+
+	// slot is owned by this worker until it is marked done
+	size_t idx;
+	while (scheduler.take(idx)){
+		task(*client, idx);
+		scheduler.done(idx);
+
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			slots[idx].done = true;
+		}
+		fetched.notify_all();
+	}
+	release(std::move(client));
+}
+
+
+void Fetcher::dispatch(size_t count, std::function<void(Client &, size_t)> task, std::function<void(size_t)> deliver){
+	slots.clear();
+	slots.resize(count);
+	for (struct slot &slot : slots)
+		slot.done = false;
+
+	// do not run too far ahead of the consumer, finished slots are held in memory
+	std::vector<std::thread> workers;
+	for (unsigned int i = 0; i < jobs && i < count; i++)
+		workers.emplace_back(&Fetcher::worker, this, task);
+
+	for (size_t idx = 0; idx < count; idx++){
+		{
+			std::unique_lock<std::mutex> guard(lock);
+			fetched.wait(guard, [&]{ return slots[idx].done; });
+		}
+
+		deliver(idx);
+		slots[idx].data = Buffer();
+		slots[idx].output = std::string();
+		scheduler.advance(idx + 1);
+	}
+
+	for (std::thread &t : workers)
+		t.join();
+	slots.clear();
+}
+
+
+unsigned int Fetcher::get_jobs(){
+	return jobs;
+}
+
+
+void Fetcher::fetch(const std::vector<std::string_view> &urls, std::function<void(size_t, Buffer &, std::string_view)> handler,
+	size_t window){
+	prefetch(urls);
+	plan(urls, window);
+
+	auto work = [&](){
+		std::unique_ptr<Client> client = acquire();
+		size_t idx;
+		while (scheduler.take(idx)){
+			Buffer data;
+			std::string_view body = client->request(std::string(urls[idx]), data);
+			scheduler.done(idx);
+			handler(idx, data, body);
+		}
+		release(std::move(client));
+	};
+
+	std::vector<std::thread> workers;
+	for (unsigned int i = 0; i < jobs && i < urls.size(); i++)
+		workers.emplace_back(work);
+	for (std::thread &t : workers)
+		t.join();
+}
+
+
+void Fetcher::advance(size_t consumed){
+	scheduler.advance(consumed);
+}
+
+
+void Fetcher::run(const std::vector<std::string_view> &urls, std::function<void(size_t, std::string_view)> handler){
+	prefetch(urls);
+
+	// sequential mode, no need for threads, one receive buffer serves all requests,
+	// scheduler still keeps rate limits of hosts
+	if (jobs == 1 || urls.size() < 2){
+		plan(urls, 1);
+		std::unique_ptr<Client> client = acquire();
+		Buffer data;
+		size_t idx;
+		while (scheduler.take(idx)){
+			handler(idx, client->request(std::string(urls[idx]), data));
+			scheduler.done(idx);
+			scheduler.advance(idx + 1);
+		}
+		release(std::move(client));
+		return;
+	}
+
+	plan(urls, jobs * FETCH_WINDOW);
+	dispatch(urls.size(),
+		[&](Client &client, size_t idx){
+			slots[idx].body = client.request(std::string(urls[idx]), slots[idx].data);
+		},
+		[&](size_t idx){
+			handler(idx, slots[idx].body);
+		}
+	);
+}
+
+
+void Fetcher::stream(const std::vector<std::string_view> &urls, std::function<void(size_t, Client &, std::ostream &)> job,
+	Output &output){
+	prefetch(urls);
+
+	// sequential mode prints straight to output as messages are parsed
+	if (jobs == 1 || urls.size() < 2){
+		plan(urls, 1);
+		std::unique_ptr<Client> client = acquire();
+		size_t idx;
+		while (scheduler.take(idx)){
+			job(idx, *client, output.stream());
+			output.feed_done();
+			scheduler.done(idx);
+			scheduler.advance(idx + 1);
+		}
+		release(std::move(client));
+		return;
+	}
+
+	plan(urls, jobs * FETCH_WINDOW);
+
+	// output of each url is collected and printed once all preceding ones were printed
+	dispatch(urls.size(),
+		[&](Client &client, size_t idx){
+			std::ostringstream out;
+			job(idx, client, out);
+			slots[idx].output = out.str();
+		},
+		[&](size_t idx){
+			output.stream() << slots[idx].output;
+			output.feed_done();
+		}
+	);
+}
@@ -0,0 +1,138 @@
+/*
+ * formats.cpp
+ *
+ * Registry of supported feed formats and their detection.
+ *
+ * Project: Reader of news feed in format Atom & RSS with support of TLS
+ * Author: Matus Remen (xremen01@stud.fit.vutbr.cz)
+ * Date: 17.10.2026
+ */
+
+#include <cstring>
+#include "../include/formats.hpp"
+
+
+// longest root element name compared with known tags
+#define ROOT_NAME_MAX 32
+
+
+// supported formats
+static const struct format FORMATS[] = {
+	{_ATOM, "Atom",      TAG_FEED,  TAG_OTHER,   TAG_ENTRY, false},
+	{_RSS2, "RSS 2.0",   TAG_RSS,   TAG_CHANNEL, TAG_ITEM,  false},
+	{_RDF,  "RSS 1.0",   TAG_RDF,   TAG_CHANNEL, TAG_ITEM,  true},
+	{_JSON, "JSON Feed", TAG_OTHER, TAG_OTHER,   TAG_OTHER, false},
+};
+
+// fields of message and elements they are read from, to read new field only a line is added here
+// dc:date and dc:creator of Dublin Core module are used by RSS 1.0 and often by RSS 2.0 feeds
+static const struct field_rule FIELD_RULES[] = {
+	{_ATOM, TAG_TITLE,     FIELD_TITLE,     nullptr, false},
+	{_ATOM, TAG_UPDATED,   FIELD_TIMESTAMP, nullptr, false},
+	{_ATOM, TAG_PUBLISHED, FIELD_TIMESTAMP, nullptr, true},
+	{_ATOM, TAG_AUTHOR,    FIELD_AUTHOR,    nullptr, false},
+	{_ATOM, TAG_LINK,      FIELD_REFERENCE, "href",  false},
+	{_ATOM, TAG_ID,        FIELD_ID,        nullptr, false},
+	{_RSS2, TAG_TITLE,     FIELD_TITLE,     nullptr, false},
+	{_RSS2, TAG_PUBDATE,   FIELD_TIMESTAMP, nullptr, false},
+	{_RSS2, TAG_DATE,      FIELD_TIMESTAMP, nullptr, true},
+	{_RSS2, TAG_AUTHOR,    FIELD_AUTHOR,    nullptr, false},
+	{_RSS2, TAG_CREATOR,   FIELD_AUTHOR,    nullptr, true},
+	{_RSS2, TAG_LINK,      FIELD_REFERENCE, nullptr, false},
+	{_RSS2, TAG_GUID,      FIELD_ID,        nullptr, false},
+	{_RDF,  TAG_TITLE,     FIELD_TITLE,     nullptr, false},
+	{_RDF,  TAG_DATE,      FIELD_TIMESTAMP, nullptr, false},
+	{_RDF,  TAG_CREATOR,   FIELD_AUTHOR,    nullptr, false},
+	{_RDF,  TAG_LINK,      FIELD_REFERENCE, nullptr, false},
+};
+
+
+const struct format *format_by_id(int id){
+	for (const struct format &format : FORMATS)
+		if (format.id == id)
+			return &format;
+	return nullptr;
+}
+
+
+const struct format *format_by_root(enum tag root){
+	if (root == TAG_OTHER)
+		return nullptr;
+	for (const struct format &format : FORMATS)
+		if (format.root == root)
+			return &format;
+	return nullptr;
+}
+
+
+const struct field_rule *find_rule(int format, enum tag tag){
+	// rules indexed by format and tag, built once from FIELD_RULES
+	static const struct dispatch {
+		const struct field_rule *rules[FORMAT_COUNT][TAG_COUNT] = {};
+		dispatch(){
+			for (const struct field_rule &rule : FIELD_RULES)
+				this->rules[rule.format][rule.tag] = &rule;
+		}
+	} table;
+	return table.rules[format][tag];
+}
+
+
+std::string_view skip_space(std::string_view data){
+	if (data.substr(0, 3) == "\xef\xbb\xbf")
+		data.remove_prefix(3);
+	size_t begin = data.find_first_not_of(" \t\r\n");
+	return begin == std::string_view::npos ? std::string_view() : data.substr(begin);
+}
+
+
+// recognize root element whose start tag begins data
+static const struct format *root_format(std::string_view data){
+	size_t end = data.find_first_of(" \t\r\n/>", 1);
+	if (end == std::string_view::npos)
+		end = data.size();
+	std::string_view name = data.substr(1, end - 1);
+	// namespace prefix, <rdf:RDF>
+	size_t colon = name.rfind(':');
+	if (colon != std::string_view::npos)
+		name.remove_prefix(colon + 1);
+	if (name.empty() || name.size() > ROOT_NAME_MAX)
+		return nullptr;
+
+	char buffer[ROOT_NAME_MAX + 1];
+	memcpy(buffer, name.data(), name.size());
+	buffer[name.size()] = '\0';
+	return format_by_root(tag_id((const xmlChar *) buffer));
+}
+
+
+const struct format *detect_format(std::string_view data){
+	data = skip_space(data);
+	if (data.empty())
+		return nullptr;
+	if (data[0] == '{')
+		return format_by_id(_JSON);
+
+	// unwanted characters in front of xml document are skipped, see Parser::strip_feed()
+	size_t pos = data.find('<');
+	while (pos != std::string_view::npos){
+		data.remove_prefix(pos);
+		if (data.substr(0, 2) == "<?")
+			pos = data.find("?>");
+		else if (data.substr(0, 4) == "<!--")
+			pos = data.find("-->");
+		else if (data.substr(0, 2) == "<!"){
+			// doctype, internal subset may contain '>'
+			size_t close = data.find('>');
+			size_t subset = data.find('[');
+			pos = subset < close ? data.find("]", subset) : close;
+		}
+		else
+			return root_format(data);
+
+		if (pos == std::string_view::npos)
+			return nullptr;
+		pos = data.find('<', pos);
+	}
+	return nullptr;
+}
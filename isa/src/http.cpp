@@ -0,0 +1,285 @@
+/*
+ * http.cpp
+ *
+ * Incremental parser of HTTP/1.1 responses working in place on receive buffer.
+ *
+ * Project: Reader of news feed in format Atom & RSS with support of TLS
+ * Author: Matus Remen (xremen01@stud.fit.vutbr.cz)
+ * Date: 17.10.2026
+ */
+
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+#include "../include/http.hpp"
+
+
+HttpParser::HttpParser(){
+	reset();
+}
+
+
+HttpParser::~HttpParser(){}
+
+
+void HttpParser::reset(){
+	this->state = HEAD;
+	this->pos = 0;
+	this->body_start = 0;
+	this->body_end = 0;
+	this->remaining = 0;
+	this->length = 0;
+}
+
+
+void HttpParser::parse_field(std::string_view field, std::map<std::string, std::string> &fields){
+	size_t colon = field.find(':');
+	if (colon == std::string_view::npos)
+		return;
+
+	std::string name(field.substr(0, colon));
+	for (char &c : name)
+		c = static_cast<char>(tolower(c));
+
+	std::string_view value = field.substr(colon + 1);
+	size_t value_start = value.find_first_not_of(" \t");
+	size_t value_end = value.find_last_not_of(" \t");
+	value = value_start == std::string_view::npos ?
+		std::string_view() : value.substr(value_start, value_end - value_start + 1);
+
+	// repeated fields are joined into comma separated list
+	auto known = fields.find(name);
+	if (known != fields.end())
+		known->second += ", " + std::string(value);
+	else
+		fields[name] = std::string(value);
+}
+
+
+bool HttpParser::parse_head(std::string_view head, struct response &resp){
+	resp.version.clear();
+	resp.status_code.clear();
+	resp.headers.clear();
+	resp.trailers.clear();
+	resp.body = std::string_view();
+
+	// status line
+	size_t line = head.find("\r\n");
+	std::string_view status = head.substr(0, line);
+	size_t space = status.find(' ');
+	if (space == std::string_view::npos)
+		return false;
+	resp.version = std::string(status.substr(0, space));
+
+	size_t code = status.find_first_not_of(' ', space);
+	if (code == std::string_view::npos)
+		return false;
+	resp.status_code = std::string(status.substr(code, status.find(' ', code) - code));
+	if (resp.version.compare(0, 5, "HTTP/") || resp.status_code.size() != 3)
+		return false;
+
+	// header fields
+	while (line != std::string_view::npos && line < head.size()){
+		size_t start = line + 2;
+		line = head.find("\r\n", start);
+		parse_field(head.substr(start, line == std::string_view::npos ? line : line - start), resp.headers);
+	}
+
+	return true;
+}
+
+
+void HttpParser::start_body(struct response &resp){
+	std::string connection = resp.headers["connection"];
+	for (char &c : connection)
+		c = static_cast<char>(tolower(c));
+	resp.keep_alive = resp.version == "HTTP/1.1" ?
+		connection.find("close") == std::string::npos : connection.find("keep-alive") != std::string::npos;
+
+	// responses without body
+	if (resp.status_code == "204" || resp.status_code == "304"){
+		this->state = DONE;
+		return;
+	}
+
+	std::string encoding = resp.headers["transfer-encoding"];
+	for (char &c : encoding)
+		c = static_cast<char>(tolower(c));
+	if (encoding.find("chunked") != std::string::npos){
+		this->state = CHUNK_SIZE;
+		return;
+	}
+
+	auto length = resp.headers.find("content-length");
+	if (length != resp.headers.end()){
+		char *end = nullptr;
+		this->length = strtoull(length->second.c_str(), &end, 10);
+		if (length->second.empty() || *end){
+			this->state = ERROR;
+			return;
+		}
+		this->remaining = this->length;
+		this->state = this->length ? BODY_LENGTH : DONE;
+		return;
+	}
+
+	// body without framing is delimited by closing the connection
+	resp.keep_alive = false;
+	this->state = BODY_EOF;
+}
+
+
+int HttpParser::parse(Buffer &data, struct response &resp){
+	std::string_view raw = data.view();
+
+	while (true){
+		switch (this->state){
+			case HEAD:{
+				size_t head_end = raw.find("\r\n\r\n", this->pos);
+				if (head_end == std::string_view::npos){
+					if (raw.size() - this->pos > HTTP_MAX_HEAD)
+						this->state = ERROR;
+					else
+						return HTTP_MORE;
+					break;
+				}
+				if (!parse_head(raw.substr(this->pos, head_end - this->pos), resp)){
+					this->state = ERROR;
+					break;
+				}
+				this->pos = head_end + 4;
+				// interim 1xx responses are skipped
+				if (resp.status_code[0] == '1')
+					break;
+
+				this->body_start = this->pos;
+				this->body_end = this->pos;
+				start_body(resp);
+				break;}
+
+			case CHUNK_SIZE:{
+				// chunk extensions after ';' are ignored
+				size_t line = raw.find("\r\n", this->pos);
+				if (line == std::string_view::npos)
+					return HTTP_MORE;
+
+				const char *size = raw.data() + this->pos;
+				char *end = nullptr;
+				if (!isxdigit(static_cast<unsigned char>(*size))){
+					this->state = ERROR;
+					break;
+				}
+				// size must be followed by extension, whitespace or end of line and fit in 64 bits
+				errno = 0;
+				this->remaining = strtoull(size, &end, 16);
+				if (end == size || errno == ERANGE || (*end != ';' && *end != ' ' && *end != '\t' && *end != '\r')){
+					this->state = ERROR;
+					break;
+				}
+				this->pos = line + 2;
+				this->state = this->remaining ? CHUNK_DATA : TRAILER;
+				break;}
+
+			case CHUNK_DATA:{
+				// payload is moved right behind payload of previous chunks
+				size_t available = std::min(raw.size() - this->pos, this->remaining);
+				memmove(data.data() + this->body_end, data.data() + this->pos, available);
+				this->body_end += available;
+				this->pos += available;
+				this->remaining -= available;
+				if (this->remaining)
+					return HTTP_MORE;
+				this->state = CHUNK_END;
+				break;}
+
+			case CHUNK_END:{
+				if (raw.size() - this->pos < 2)
+					return HTTP_MORE;
+				if (raw.compare(this->pos, 2, "\r\n")){
+					this->state = ERROR;
+					break;
+				}
+				this->pos += 2;
+				this->state = CHUNK_SIZE;
+				break;}
+
+			case TRAILER:{
+				size_t line = raw.find("\r\n", this->pos);
+				if (line == std::string_view::npos)
+					return HTTP_MORE;
+				if (line == this->pos){
+					this->pos += 2;
+					this->state = DONE;
+					break;
+				}
+				parse_field(raw.substr(this->pos, line - this->pos), resp.trailers);
+				this->pos = line + 2;
+				break;}
+
+			case BODY_LENGTH:{
+				size_t available = std::min(raw.size() - this->pos, this->remaining);
+				this->pos += available;
+				this->body_end = this->pos;
+				this->remaining -= available;
+				if (this->remaining)
+					return HTTP_MORE;
+				this->state = DONE;
+				break;}
+
+			case BODY_EOF:{
+				this->pos = raw.size();
+				this->body_end = this->pos;
+				return HTTP_MORE;}
+
+			case DONE:{
+				resp.body = body(data);
+				return HTTP_DONE;}
+
+			case ERROR:
+			default:
+				return HTTP_ERROR;
+		}
+	}
+}
+
+
+int HttpParser::eof(Buffer &data, struct response &resp){
+	if (this->state == BODY_EOF){
+		parse(data, resp);
+		this->state = DONE;
+		return parse(data, resp);
+	}
+	// connection closed in the middle of response
+	if (this->state != DONE)
+		this->state = ERROR;
+	return parse(data, resp);
+}
+
+
+void HttpParser::consume(Buffer &data){
+	if (this->state == HEAD)
+		return;
+
+	data.erase(this->body_start, this->pos - this->body_start);
+	this->pos = this->body_start;
+	this->body_end = this->body_start;
+}
+
+
+bool HttpParser::head_done(){
+	return this->state != HEAD && this->state != ERROR;
+}
+
+
+std::string_view HttpParser::body(Buffer &data){
+	if (this->state == HEAD)
+		return std::string_view();
+	return data.view(this->body_start, this->body_end - this->body_start);
+}
+
+
+size_t HttpParser::content_length(){
+	return this->length;
+}
@@ -0,0 +1,111 @@
+/*
+ * index.cpp
+ *
+ * In-memory index of latest parsed entries of feeds.
+ *
+ * Project: Reader of news feed in format Atom & RSS with support of TLS
+ * Author: Matus Remen (xremen01@stud.fit.vutbr.cz)
+ * Date: 17.10.2026
+ */
+
+#include <mutex>
+#include "../include/index.hpp"
+#include "../include/poll.hpp"
+
+
+EntryIndex::EntryIndex(){}
+
+
+EntryIndex::~EntryIndex(){}
+
+
+void EntryIndex::replace(std::string url, std::string title, std::vector<struct stored_entry> entries, time_t now){
+	std::unique_lock<std::shared_mutex> guard(lock);
+	struct feed &feed = this->feeds[url];
+	for (timeline::iterator position : feed.positions)
+		this->recent.erase(position);
+
+	feed.url = url;
+	feed.title = std::move(title);
+	feed.fetched = now;
+	feed.entries = std::move(entries);
+	feed.positions.clear();
+	feed.positions.reserve(feed.entries.size());
+	for (const struct stored_entry &e : feed.entries)
+		feed.positions.push_back(this->recent.emplace(e.time, std::make_pair(&feed, &e)));
+}
+
+
+void EntryIndex::write(std::ostream &out, Sink &sink, const struct feed &feed, const struct stored_entry &e, int idx){
+	struct entry view = {feed.url, feed.title, e.title, e.timestamp, e.author, e.reference};
+	sink.message(out, view, idx);
+}
+
+
+void EntryIndex::list(std::ostream &out){
+	std::shared_lock<std::shared_mutex> guard(lock);
+	for (auto &feed : this->feeds)
+		out << feed.second.url << '\t' << feed.second.fetched << '\t' << feed.second.entries.size() << '\t'
+			<< feed.second.title << '\n';
+}
+
+
+bool EntryIndex::entries(std::ostream &out, Sink &sink, std::string_view url){
+	std::shared_lock<std::shared_mutex> guard(lock);
+	auto feed = this->feeds.find(url);
+	if (feed == this->feeds.end())
+		return false;
+
+	sink.header(out);
+	if (!feed->second.title.empty())
+		sink.feed(out, feed->second.url, feed->second.title);
+	int idx = 0;
+	for (const struct stored_entry &e : feed->second.entries)
+		write(out, sink, feed->second, e, idx++);
+	return true;
+}
+
+
+void EntryIndex::latest(std::ostream &out, Sink &sink, size_t count){
+	std::shared_lock<std::shared_mutex> guard(lock);
+	sink.header(out);
+	int idx = 0;
+	for (auto e = this->recent.rbegin(); e != this->recent.rend() && count; e++, count--)
+		write(out, sink, *e->second.first, *e->second.second, idx++);
+}
+
+
+size_t EntryIndex::feed_count(){
+	std::shared_lock<std::shared_mutex> guard(lock);
+	return this->feeds.size();
+}
+
+
+size_t EntryIndex::entry_count(){
+	std::shared_lock<std::shared_mutex> guard(lock);
+	return this->recent.size();
+}
+
+
+IndexSink::IndexSink(time_t now){
+	this->now = now;
+}
+
+
+void IndexSink::feed(std::ostream &, std::string_view, std::string_view title){
+	this->title = std::string(title);
+}
+
+
+void IndexSink::message(std::ostream &, const struct entry &e, int){
+	time_t time = PollStore::parse_time(e.timestamp);
+	this->entries.push_back({std::string(e.title), std::string(e.timestamp), std::string(e.author),
+		std::string(e.reference), time ? time : this->now});
+}
+
+
+void IndexSink::commit(EntryIndex &index, std::string url){
+	index.replace(url, std::move(this->title), std::move(this->entries), this->now);
+	this->title.clear();
+	this->entries.clear();
+}
@@ -0,0 +1,387 @@
+/*
+ * json.cpp
+ *
+ * Streaming reader of JSON documents and JSON Feed format.
+ *
+ * Project: Reader of news feed in format Atom & RSS with support of TLS
+ * Author: Matus Remen (xremen01@stud.fit.vutbr.cz)
+ * Date: 17.10.2026
+ */
+
+#include <cctype>
+#include <cstring>
+#include "../include/json.hpp"
+
+
+JsonReader::JsonReader(std::string_view data){
+	this->pos = data.data();
+	this->end = data.data() + data.size();
+	this->failed = false;
+	this->after_value = false;
+}
+
+
+bool JsonReader::space(){
+	while (this->pos < this->end && (*this->pos == ' ' || *this->pos == '\t' || *this->pos == '\r' || *this->pos == '\n'))
+		this->pos++;
+	return this->pos < this->end;
+}
+
+
+bool JsonReader::fail(){
+	this->failed = true;
+	return false;
+}
+
+
+void JsonReader::append_utf8(std::string &out, unsigned long code){
+	if (code < 0x80)
+		out += static_cast<char>(code);
+	else if (code < 0x800){
+		out += static_cast<char>(0xc0 | code >> 6);
+		out += static_cast<char>(0x80 | (code & 0x3f));
+	}
+	else if (code < 0x10000){
+		out += static_cast<char>(0xe0 | code >> 12);
+		out += static_cast<char>(0x80 | (code >> 6 & 0x3f));
+		out += static_cast<char>(0x80 | (code & 0x3f));
+	}
+	else {
+		out += static_cast<char>(0xf0 | code >> 18);
+		out += static_cast<char>(0x80 | (code >> 12 & 0x3f));
+		out += static_cast<char>(0x80 | (code >> 6 & 0x3f));
+		out += static_cast<char>(0x80 | (code & 0x3f));
+	}
+}
+
+
+bool JsonReader::read_hex(unsigned long &code){
+	if (this->end - this->pos < 4)
+		return fail();
+	code = 0;
+	for (int i = 0; i < 4; i++){
+		char c = *this->pos++;
+		code <<= 4;
+		if (c >= '0' && c <= '9')
+			code |= c - '0';
+		else if ((c | 0x20) >= 'a' && (c | 0x20) <= 'f')
+			code |= (c | 0x20) - 'a' + 10;
+		else
+			return fail();
+	}
+	return true;
+}
+
+
+bool JsonReader::read_string(std::string_view &value, std::string &scratch){
+	const char *start = ++this->pos;
+	const char *quote = static_cast<const char *>(memchr(start, '"', this->end - start));
+	if (!quote)
+		return fail();
+
+	// common case, string without escape sequences is returned as it is in document
+	const char *escape = static_cast<const char *>(memchr(start, '\\', quote - start));
+	if (!escape){
+		value = std::string_view(start, quote - start);
+		this->pos = quote + 1;
+		return true;
+	}
+
+	scratch.assign(start, escape - start);
+	this->pos = escape;
+	while (this->pos < this->end){
+		char c = *this->pos++;
+		if (c == '"'){
+			value = scratch;
+			return true;
+		}
+		if (c != '\\'){
+			scratch += c;
+			continue;
+		}
+		if (this->pos == this->end)
+			return fail();
+
+		switch (c = *this->pos++){
+			case '"': case '\\': case '/': scratch += c; break;
+			case 'b': scratch += '\b'; break;
+			case 'f': scratch += '\f'; break;
+			case 'n': scratch += '\n'; break;
+			case 'r': scratch += '\r'; break;
+			case 't': scratch += '\t'; break;
+			case 'u':{
+				unsigned long code;
+				if (!read_hex(code))
+					return false;
+				// surrogate pair encodes code point above U+FFFF, lone surrogate is replaced
+				if (code >= 0xd800 && code <= 0xdbff && this->end - this->pos >= 6 && this->pos[0] == '\\' && this->pos[1] == 'u'){
+					this->pos += 2;
+					unsigned long low;
+					if (!read_hex(low))
+						return false;
+					if (low >= 0xdc00 && low <= 0xdfff)
+						code = 0x10000 + ((code - 0xd800) << 10) + (low - 0xdc00);
+					else {
+						append_utf8(scratch, 0xfffd);
+						code = low;
+					}
+				}
+				if (code >= 0xd800 && code <= 0xdfff)
+					code = 0xfffd;
+				append_utf8(scratch, code);
+				break;}
+			default:
+				return fail();
+		}
+	}
+	return fail();
+}
+
+
+bool JsonReader::object(){
+	if (this->failed || !space() || *this->pos != '{')
+		return false;
+	this->pos++;
+	this->after_value = false;
+	return true;
+}
+
+
+bool JsonReader::key(std::string_view &name){
+	if (this->failed)
+		return false;
+	if (!space())
+		return fail();
+	if (*this->pos == '}'){
+		this->pos++;
+		this->after_value = true;
+		return false;
+	}
+	if (this->after_value){
+		if (*this->pos != ',')
+			return fail();
+		this->pos++;
+		if (!space())
+			return fail();
+	}
+	if (*this->pos != '"' || !read_string(name, this->key_buffer))
+		return fail();
+	if (!space() || *this->pos != ':')
+		return fail();
+	this->pos++;
+	this->after_value = false;
+	return true;
+}
+
+
+bool JsonReader::array(){
+	if (this->failed || !space() || *this->pos != '[')
+		return false;
+	this->pos++;
+	this->after_value = false;
+	return true;
+}
+
+
+bool JsonReader::next(){
+	if (this->failed)
+		return false;
+	if (!space())
+		return fail();
+	if (*this->pos == ']'){
+		this->pos++;
+		this->after_value = true;
+		return false;
+	}
+	if (this->after_value){
+		if (*this->pos != ',')
+			return fail();
+		this->pos++;
+		this->after_value = false;
+	}
+	return true;
+}
+
+
+bool JsonReader::string(std::string_view &value, std::string &scratch){
+	if (this->failed)
+		return false;
+	if (!space())
+		return fail();
+	if (*this->pos != '"')
+		return false;
+	if (!read_string(value, scratch))
+		return false;
+	this->after_value = true;
+	return true;
+}
+
+
+bool JsonReader::skip(){
+	if (this->failed)
+		return false;
+	if (!space())
+		return fail();
+
+	int depth = 0;
+	do {
+		char c = *this->pos;
+		if (c == '"'){
+			// escaped characters are jumped over, string is not decoded
+			for (this->pos++; this->pos < this->end && *this->pos != '"'; this->pos++)
+				if (*this->pos == '\\')
+					this->pos++;
+			if (this->pos >= this->end)
+				return fail();
+			this->pos++;
+		}
+		else if (c == '{' || c == '['){
+			depth++;
+			this->pos++;
+		}
+		else if (c == '}' || c == ']'){
+			if (--depth < 0)
+				return fail();
+			this->pos++;
+		}
+		else if (c == ',' || c == ':'){
+			if (!depth)
+				return fail();
+			this->pos++;
+		}
+		else {
+			// number, true, false or null
+			const char *start = this->pos;
+			while (this->pos < this->end && (isalnum(static_cast<unsigned char>(*this->pos)) || *this->pos == '-'
+					|| *this->pos == '+' || *this->pos == '.'))
+				this->pos++;
+			if (this->pos == start)
+				return fail();
+		}
+	} while (depth && space());
+
+	if (depth)
+		return fail();
+	this->after_value = true;
+	return true;
+}
+
+
+bool JsonReader::ok(){
+	return !this->failed;
+}
+
+
+// fields of JSON Feed item, keys are compared only until the first match
+static const struct {
+	const char *key;
+	enum field field;
+	bool fallback;  // key is used only if no other key fills the field
+} JSON_FIELDS[] = {
+	{"title",          FIELD_TITLE,     false},
+	{"date_modified",  FIELD_TIMESTAMP, false},
+	{"date_published", FIELD_TIMESTAMP, true},
+	{"url",            FIELD_REFERENCE, false},
+	{"external_url",   FIELD_REFERENCE, true},
+	{"id",             FIELD_ID,        false},
+};
+
+
+bool JsonFeed::read_text(JsonReader &json, Arena &arena, std::string_view &text){
+	std::string_view value;
+	if (!json.string(value, this->scratch)){
+		json.skip();
+		return false;
+	}
+	text = arena.store(value);
+	return true;
+}
+
+
+bool JsonFeed::read_author(JsonReader &json, Arena &arena, std::string_view &author){
+	if (!json.object()){
+		json.skip();
+		return false;
+	}
+	std::string_view name;
+	while (json.key(name)){
+		if (name == "name")
+			read_text(json, arena, author);
+		else
+			json.skip();
+	}
+	return json.ok();
+}
+
+
+bool JsonFeed::read_item(JsonReader &json, Arena &arena, struct record &item){
+	std::string_view name;
+	while (json.key(name)){
+		// authors of version 1.1 replace author of version 1.0
+		if (name == "authors"){
+			if (!json.array()){
+				json.skip();
+				continue;
+			}
+			for (bool first = true; json.next(); first = false){
+				if (first)
+					read_author(json, arena, item.fields[FIELD_AUTHOR]);
+				else
+					json.skip();
+			}
+			continue;
+		}
+		if (name == "author"){
+			if (item.fields[FIELD_AUTHOR].empty())
+				read_author(json, arena, item.fields[FIELD_AUTHOR]);
+			else
+				json.skip();
+			continue;
+		}
+
+		bool known = false;
+		for (auto &rule : JSON_FIELDS){
+			if (name != rule.key)
+				continue;
+			known = true;
+			if (rule.fallback && !item.fields[rule.field].empty())
+				json.skip();
+			else
+				read_text(json, arena, item.fields[rule.field]);
+			break;
+		}
+		if (!known)
+			json.skip();
+	}
+	return json.ok();
+}
+
+
+bool JsonFeed::read(std::string_view data, Arena &arena){
+	this->title = std::string_view();
+	this->items.clear();
+
+	JsonReader json(skip_space(data));
+	if (!json.object())
+		return false;
+
+	std::string_view name;
+	while (json.key(name)){
+		if (name == "title")
+			read_text(json, arena, this->title);
+		else if (name == "items" && json.array()){
+			while (json.next()){
+				struct record item;
+				if (json.object()){
+					read_item(json, arena, item);
+					this->items.push_back(item);
+				}
+				else
+					json.skip();
+			}
+		}
+		else
+			json.skip();
+	}
+	return json.ok();
+}
@@ -0,0 +1,65 @@
+/*
+ * output.cpp
+ *
+ * Batched program output with flush policy.
+ *
+ * Project: Reader of news feed in format Atom & RSS with support of TLS
+ * Author: Matus Remen (xremen01@stud.fit.vutbr.cz)
+ * Date: 17.10.2026
+ */
+
+#include <cstdlib>
+#include "../include/output.hpp"
+
+
+// size policy is implemented by buffer of threshold size, others use full sized buffer
+Output::Output(int fd, int policy, size_t threshold)
+	: writer(fd, policy == FLUSH_SIZE ? threshold : WRITER_BUFFER), out(&writer){
+	this->policy = policy;
+}
+
+
+Output::~Output(){
+	flush();
+}
+
+
+std::ostream &Output::stream(){
+	return this->out;
+}
+
+
+void Output::feed_done(){
+	if (this->policy == FLUSH_FEED)
+		this->writer.flush();
+}
+
+
+bool Output::flush(){
+	return this->writer.flush();
+}
+
+
+uint64_t Output::writes(){
+	return this->writer.writes();
+}
+
+
+bool Output::parse_policy(std::string name, int &policy, size_t &threshold){
+	if (name == "feed"){
+		policy = FLUSH_FEED;
+		return true;
+	}
+	if (name == "exit"){
+		policy = FLUSH_EXIT;
+		return true;
+	}
+
+	char *end = nullptr;
+	long long size = strtoll(name.c_str(), &end, 10);
+	if (name.empty() || *end || size < 1 || size > FLUSH_MAX)
+		return false;
+	policy = FLUSH_SIZE;
+	threshold = static_cast<size_t>(size);
+	return true;
+}
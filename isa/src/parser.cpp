@@ -8,30 +8,44 @@
  * Date: 05.11.2022
  */
 
+#include <climits>
+#include <cstring>
 #include "../include/parser.hpp"
 
 
-Parser::Parser(std::string feed, bool _ts, bool _au, bool _ref){
+Parser::Parser(std::string_view feed, bool _ts, bool _au, bool _ref, std::ostream &out) : out(out){
 	this->filter = 0;
 	this->filter |= (_ts ? _TS_OPT : 0);
 	this->filter |= (_au ? _AU_OPT : 0);
 	this->filter |= (_ref ? _REF_OPT : 0);
-
-	this->feed = feed;
-	this->strip_feed();
-
-	this->document = xmlParseDoc((const xmlChar *) this->feed.c_str());
-	if (!this->document){
-		xmlCleanupParser();
-		this->document = nullptr;
-		this->root = nullptr;
+	this->seen = nullptr;
+	this->poll = nullptr;
+	this->text_sink = std::unique_ptr<Sink>(new TextSink(this->filter));
+	this->sink = this->text_sink.get();
+
+	this->document = nullptr;
+	this->root = nullptr;
+	this->json_valid = false;
+
+	// format is known from first bytes, documents of other formats (e.g. html pages) are not parsed at all
+	this->format = detect_format(feed);
+	if (!this->format)
+		return;
+	if (this->format->id == _JSON){
+		this->json_valid = this->json.read(feed, this->arena);
 		return;
 	}
 
-	this->root = xmlDocGetRootElement(document);
+	// document is parsed straight from the received buffer, libxml2 builds its own tree
+	std::string_view xml = strip_feed(feed);
+	if (!xml.empty() && xml.size() <= INT_MAX)
+		this->document = xmlReadMemory(xml.data(), static_cast<int>(xml.size()), nullptr, nullptr, 0);
+	if (!this->document)
+		return;
+
+	this->root = xmlDocGetRootElement(this->document);
 	if (!this->root){
 		xmlFreeDoc(this->document);
-		xmlCleanupParser();
 		this->document = nullptr;
 		this->root = nullptr;
 		return;
@@ -40,135 +54,186 @@ Parser::Parser(std::string feed, bool _ts, bool _au, bool _ref){
 
 
 Parser::~Parser(){
+	// libxml2 is cleaned up once at exit, parsers may run in multiple threads
 	if (document){
 		xmlFreeDoc(this->document);
 	}
-	xmlCleanupParser();
 }
 
 
-void Parser::strip_feed(){
-	const char *feed_c = this->feed.c_str();
-	char *begin = nullptr;
-	char *end = nullptr;
+std::string_view Parser::strip_feed(std::string_view feed){
+	if (feed.empty())
+		return std::string_view();
+	const char *begin = static_cast<const char *>(memchr(feed.data(), '<', feed.size()));
+	if (!begin)
+		return std::string_view();
+#ifdef __APPLE__
+	size_t last = feed.rfind('>');
+	const char *end = last == std::string_view::npos ? nullptr : feed.data() + last;
+#else
+	const char *end = static_cast<const char *>(memrchr(begin, '>', feed.data() + feed.size() - begin));
+#endif
+	if (!end || end < begin)
+		return std::string_view();
+	return std::string_view(begin, end - begin + 1);
+}
 
-	for (const char *p = feed_c; *p; p++){
-		if (!begin && *p == '<')
-			begin = const_cast<char *>(p);
-		else if (*p == '>')
-			end = const_cast<char *>(p+1);
-	}
-	this->feed = std::string(begin, end);
+
+void Parser::set_seen_store(SeenStore *seen, std::string url){
+	this->seen = seen;
+	this->url = url;
 }
 
 
-void Parser::print_message(std::string title, std::string ts, std::string au, std::string ref, int idx){
-	if (idx && this->filter && (!ts.empty() || !au.empty() || !ref.empty()))
-		std::cout << "\n";
-	std::cout << title << std::endl;
-	if (this->filter & _TS_OPT && !ts.empty())
-		std::cout << "Aktualizace: " << ts << std::endl;
-	if (this->filter & _AU_OPT && !au.empty())
-		std::cout << "Autor: " << au << std::endl;
-	if (this->filter & _REF_OPT && !ref.empty())
-		std::cout << "URL: " << ref << std::endl;
+void Parser::set_sink(Sink *sink, std::string url){
+	this->sink = sink ? sink : this->text_sink.get();
+	this->url = url;
 }
 
 
-void Parser::parse_atom(){
-	// title
-	for (xmlNodePtr node = root->children; node; node = node->next)
-		if (!xmlStrcasecmp(node->name, (xmlChar *) "title")){
-			std::cout << "*** " << (char *) xmlNodeGetContent(node) << " ***" << std::endl;
-			break;
-		}
+void Parser::set_poll_store(PollStore *poll, std::string url){
+	this->poll = poll;
+	this->url = url;
+}
 
-	// feed
-	xmlNodePtr feed;
-	for (feed = root->children; feed && xmlStrcasecmp(feed->name, (xmlChar *) "entry"); feed = feed->next);
-	
-	int idx = 0;
-	for (feed = root->children; feed; feed = feed->next){
-		if (xmlStrcasecmp(feed->name, (xmlChar *) "entry"))
-			continue;
 
-		// feed entries
-		std::string title, timestamp, author, reference;
-		for (xmlNodePtr entry = feed->children; entry; entry = entry->next){
-			if (!xmlStrcasecmp(entry->name, (xmlChar *) "title"))
-				title = std::string((char *) xmlNodeGetContent(entry));
-			else if (!xmlStrcasecmp(entry->name, (xmlChar *) "updated"))
-				timestamp = std::string((char *) xmlNodeGetContent(entry));
-			else if (!xmlStrcasecmp(entry->name, (xmlChar *) "author")){
-				xmlNodePtr author_node;
-				for (
-					author_node = entry->children;
-					author_node && xmlStrcasecmp(author_node->name, (xmlChar *) "name");
-					author_node = author_node->next
-				);
-				author = std::string((char *) xmlNodeGetContent(entry));
-			} else if (!xmlStrcasecmp(entry->name, (xmlChar *) "link"))
-				reference = std::string((char *) xmlGetProp(entry, (xmlChar *) "href"));
-		}
+std::string_view Parser::entry_key(std::string_view id, std::string_view reference, std::string_view title){
+	if (!id.empty())
+		return id;
+	if (!reference.empty())
+		return reference;
+	return title;
+}
+
+
+bool Parser::unseen(std::string_view id, std::string_view reference, std::string_view title){
+	return !this->seen || this->seen->add(this->url, entry_key(id, reference, title));
+}
+
+
+void Parser::emit_title(std::string_view title){
+	this->feed_title = title;
+	this->sink->feed(this->out, this->url, this->feed_title);
+}
+
+
+void Parser::emit_message(struct record &msg, int &idx){
+	std::string_view *f = msg.fields;
+	// every entry counts for update history, also the ones which are not printed
+	if (this->poll)
+		PollStore::observe(this->sample, entry_key(f[FIELD_ID], f[FIELD_REFERENCE], f[FIELD_TITLE]), f[FIELD_TIMESTAMP]);
+	if (f[FIELD_TITLE].empty() || !unseen(f[FIELD_ID], f[FIELD_REFERENCE], f[FIELD_TITLE]))
+		return;
+
+	struct entry e = {this->url, this->feed_title, f[FIELD_TITLE], f[FIELD_TIMESTAMP], f[FIELD_AUTHOR], f[FIELD_REFERENCE]};
+	this->sink->message(this->out, e, idx);
+	idx++;
+}
+
 
-		if (title.empty())
+void Parser::extract(xmlNodePtr entry, int format, struct record &msg){
+	for (xmlNodePtr node = entry->children; node; node = node->next){
+		if (node->type != XML_ELEMENT_NODE)
 			continue;
-		
-		this->print_message(title, timestamp, author, reference, idx);
-		idx++;
+		const struct field_rule *rule = find_rule(format, this->tags.lookup(node->name));
+		if (!rule || (rule->fallback && !msg.fields[rule->field].empty()))
+			continue;
+		// last occurrence of field wins
+		msg.fields[rule->field] = rule->attr ? this->arena.prop(node, rule->attr) : this->arena.text(node);
 	}
 }
 
 
-void Parser::parse_rss2(){
-	// title
-	xmlNodePtr channel = nullptr;
-	for (xmlNodePtr node = root->children; node; node = node->next){
-		if (xmlStrcasecmp(node->name, (xmlChar *) "channel"))
-			continue;
-		for (channel = node->children; channel; channel = channel->next){
-			if (!xmlStrcasecmp(channel->name, (xmlChar*) "title")){
-				std::cout << "*** " << (char *) xmlNodeGetContent(channel) << " ***" << std::endl;
-				channel = node;
+void Parser::parse_channel(xmlNodePtr channel, xmlNodePtr entries, const struct format *format){
+	// messages in front of feed title wait until title is printed
+	std::vector<struct record> pending;
+	bool title_found = false;
+	int idx = 0;
+
+	if (channel != entries){
+		for (xmlNodePtr node = channel->children; node; node = node->next)
+			if (node->type == XML_ELEMENT_NODE && this->tags.lookup(node->name) == TAG_TITLE){
+				title_found = true;
+				emit_title(this->arena.text(node));
 				break;
 			}
-		}
-		break;
 	}
 
-	// feed
-	if (!channel) return;
-	int idx = 0;
-	for (xmlNodePtr item = channel->children; item; item = item->next){
-		if (xmlStrcasecmp(item->name, (xmlChar *) "item"))
+	for (xmlNodePtr node = entries->children; node; node = node->next){
+		if (node->type != XML_ELEMENT_NODE)
 			continue;
-
-		std::string title, timestamp, author, reference;
-		for (xmlNodePtr node = item->children; node; node = node->next){
-			if (!xmlStrcasecmp(node->name, (xmlChar *) "title"))
-				title = std::string((char *) xmlNodeGetContent(node));
-			else if (!xmlStrcasecmp(node->name, (xmlChar *) "pubDate"))
-				timestamp = std::string((char *) xmlNodeGetContent(node));
-			else if (!xmlStrcasecmp(node->name, (xmlChar *) "author"))
-				author = std::string((char *) xmlNodeGetContent(node));
-			else if (!xmlStrcasecmp(node->name, (xmlChar *) "link"))
-				reference = std::string((char *) xmlNodeGetContent(node));
+		enum tag tag = this->tags.lookup(node->name);
+
+		if (tag == TAG_TITLE && !title_found && channel == entries){
+			title_found = true;
+			emit_title(this->arena.text(node));
+			for (struct record &msg : pending)
+				emit_message(msg, idx);
+			pending.clear();
+		}
+		else if (tag == format->entry){
+			struct record msg;
+			extract(node, format->id, msg);
+			if (title_found)
+				emit_message(msg, idx);
+			else
+				pending.push_back(msg);
 		}
+	}
 
-		if (title.empty())
-			continue;
-		this->print_message(title, timestamp, author, reference, idx);
-		idx++;
+	// feed without title
+	for (struct record &msg : pending)
+		emit_message(msg, idx);
+}
+
+
+bool Parser::parse_xml(){
+	// root element decides, first bytes of document could be misleading
+	const struct format *format = format_by_root(this->tags.lookup(root->name));
+	if (!format){
+		std::cerr << "Unknown feed format." << std::endl;
+		return false;
 	}
+
+	// only first channel is read
+	xmlNodePtr channel = format->channel == TAG_OTHER ? this->root : nullptr;
+	for (xmlNodePtr node = root->children; node && !channel; node = node->next)
+		if (node->type == XML_ELEMENT_NODE && this->tags.lookup(node->name) == format->channel)
+			channel = node;
+	if (!channel)
+		return false;
+
+	parse_channel(channel, format->entries_in_root ? this->root : channel, format);
+	return true;
 }
 
 
-void Parser::parse_feed(){
-	if (!xmlStrcasecmp(root->name, (xmlChar *) "feed"))
-		this->parse_atom();
-	else if (!xmlStrcasecmp(root->name, (xmlChar *) "rss"))
-		this->parse_rss2();
+bool Parser::parse_json(){
+	if (!this->json_valid){
+		std::cerr << "Invalid JSON feed." << std::endl;
+		return false;
+	}
+
+	if (!this->json.title.empty())
+		emit_title(this->json.title);
+	int idx = 0;
+	for (struct record &msg : this->json.items)
+		emit_message(msg, idx);
+	return true;
+}
+
+
+bool Parser::parse_feed(){
+	bool parsed = false;
+	if (this->format && this->format->id == _JSON)
+		parsed = this->parse_json();
+	else if (this->root)
+		parsed = this->parse_xml();
 	else
 		std::cerr << "Unknown feed format." << std::endl;
-}
 
+	// feed which could not be read stays due, it is fetched again next time
+	if (parsed && this->poll)
+		this->poll->update(this->url, this->sample, time(nullptr));
+	return parsed;
+}
@@ -0,0 +1,137 @@
+/*
+ * pipeline.cpp
+ *
+ * Fetching, parsing and printing of feeds in separate concurrent stages.
+ *
+ * Project: Reader of news feed in format Atom & RSS with support of TLS
+ * Author: Matus Remen (xremen01@stud.fit.vutbr.cz)
+ * Date: 17.10.2026
+ */
+
+#include <thread>
+#include <sstream>
+#include "../include/pipeline.hpp"
+
+
+// microseconds elapsed since start
+static uint64_t elapsed_us(std::chrono::steady_clock::time_point start){
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+
+Pipeline::Pipeline(Fetcher &fetcher, unsigned int parsers) : fetcher(fetcher){
+	this->parsers = parsers ? parsers : 1;
+	this->peak_results = 0;
+	this->peak_queue = 0;
+	this->average_queue = 0;
+}
+
+
+Pipeline::~Pipeline(){}
+
+
+void Pipeline::run(const std::vector<std::string_view> &urls, std::function<void(size_t, std::string_view, std::ostream &)> parse,
+	Output &output){
+	BoundedQueue<struct job> queue(this->parsers * PARSE_QUEUE);
+	// feeds fetched ahead of output are limited as well, they would wait in queue or results
+	size_t window = this->parsers * PARSE_QUEUE + this->fetcher.get_jobs() * FETCH_WINDOW;
+	this->started = std::chrono::steady_clock::now();
+	this->results.clear();
+
+	// stage 2: parser threads
+	std::vector<std::thread> threads;
+	for (unsigned int i = 0; i < this->parsers; i++){
+		threads.emplace_back([&](){
+			struct job job;
+			while (queue.pop(job)){
+				auto start = std::chrono::steady_clock::now();
+				std::ostringstream out;
+				parse(job.idx, job.body, out);
+				std::string text = out.str();
+				this->parsed.busy_us += elapsed_us(start);
+				this->parsed.items++;
+				this->parsed.bytes += job.body.size();
+				job.data = Buffer();
+
+				{
+					std::lock_guard<std::mutex> guard(lock);
+					results[job.idx] = std::move(text);
+					if (results.size() > peak_results)
+						peak_results = results.size();
+				}
+				result_ready.notify_all();
+			}
+		});
+	}
+
+	// stage 1: fetcher workers, finished feeds are handed to parsers as they come
+	threads.emplace_back([&](){
+		this->fetcher.fetch(urls, [&](size_t idx, Buffer &data, std::string_view body){
+			this->fetched.items++;
+			this->fetched.bytes += body.size();
+			queue.push({idx, std::move(data), body});
+		}, window);
+		queue.close();
+	});
+
+	// stage 3: output in list order
+	for (size_t idx = 0; idx < urls.size(); idx++){
+		std::string text;
+		{
+			std::unique_lock<std::mutex> guard(lock);
+			result_ready.wait(guard, [&]{ return results.count(idx); });
+			text = std::move(results[idx]);
+			results.erase(idx);
+		}
+
+		auto start = std::chrono::steady_clock::now();
+		output.stream() << text;
+		output.feed_done();
+		this->printed.busy_us += elapsed_us(start);
+		this->printed.items++;
+		this->printed.bytes += text.size();
+
+		this->fetcher.advance(idx + 1);
+	}
+
+	for (std::thread &thread : threads)
+		thread.join();
+	this->finished = std::chrono::steady_clock::now();
+	this->peak_queue = queue.peak_depth();
+	this->average_queue = queue.average_depth();
+}
+
+
+void Pipeline::print_stats(std::ostream &out){
+	double seconds = std::chrono::duration<double>(this->finished - this->started).count();
+	if (seconds <= 0)
+		seconds = 1e-9;
+
+	struct {
+		const char *name;
+		struct counters &stage;
+		bool queue;  // stage fills a buffer of next stage
+		size_t peak;
+	} stages[] = {
+		{"fetch", this->fetched, true, this->peak_queue},
+		{"parse", this->parsed, true, this->peak_results},
+		{"output", this->printed, false, 0},
+	};
+
+	for (auto &s : stages){
+		out << "stage=" << s.name
+			<< " items=" << s.stage.items
+			<< " bytes=" << s.stage.bytes
+			<< " items_per_s=" << s.stage.items / seconds
+			<< " bytes_per_s=" << s.stage.bytes / seconds;
+		// fetch time is spent waiting for network, it is included in elapsed time only
+		if (&s.stage != &this->fetched)
+			out << " busy_s=" << s.stage.busy_us / 1e6;
+		if (s.queue)
+			out << " queue_peak=" << s.peak;
+		if (&s.stage == &this->fetched)
+			out << " queue_avg=" << this->average_queue;
+		out << "\n";
+	}
+	out << "elapsed_s=" << seconds << "\n";
+}
@@ -0,0 +1,278 @@
+/*
+ * poll.cpp
+ *
+ * Polling intervals of feeds learned from their update history.
+ *
+ * Project: Reader of news feed in format Atom & RSS with support of TLS
+ * Author: Matus Remen (xremen01@stud.fit.vutbr.cz)
+ * Date: 17.10.2026
+ */
+
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <functional>
+#include <strings.h>
+#include <unistd.h>
+#include "../include/poll.hpp"
+
+// FNV-1a 64-bit, fingerprints have to be the same in every run
+#define FNV_OFFSET 14695981039346656037ULL
+#define FNV_PRIME  1099511628211ULL
+
+
+PollStore::PollStore(){}
+
+
+PollStore::~PollStore(){}
+
+
+bool PollStore::load(std::string path){
+	FILE *file = fopen(path.c_str(), "r");
+	if (!file)
+		return false;
+
+	// first line identifies format, then one feed per line: checked, interval, digest (hex) and url
+	char magic[16] = "";
+	if (!fgets(magic, sizeof(magic), file) || strncmp(magic, POLL_MAGIC "\n", sizeof(POLL_MAGIC))){
+		fclose(file);
+		return false;
+	}
+
+	std::lock_guard<std::mutex> guard(lock);
+	long long checked;
+	double interval;
+	unsigned long long digest;
+	char url[4096];
+	while (fscanf(file, "%lld %lf %llx %4095s", &checked, &interval, &digest, url) == 4)
+		this->feeds[url] = {static_cast<time_t>(checked), interval, static_cast<uint64_t>(digest)};
+	fclose(file);
+	return true;
+}
+
+
+bool PollStore::save(std::string path){
+	std::string tmp = path + ".tmp";
+	FILE *file = fopen(tmp.c_str(), "w");
+	if (!file)
+		return false;
+
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		fprintf(file, "%s\n", POLL_MAGIC);
+		for (auto &feed : this->feeds)
+			fprintf(file, "%lld %.0f %llx %s\n", static_cast<long long>(feed.second.checked), feed.second.interval,
+				static_cast<unsigned long long>(feed.second.digest), feed.first.c_str());
+	}
+
+	bool ok = !ferror(file);
+	ok = !fclose(file) && ok;
+	if (!ok || rename(tmp.c_str(), path.c_str())){
+		unlink(tmp.c_str());
+		return false;
+	}
+	return true;
+}
+
+
+bool PollStore::due(std::string_view url, time_t now){
+	time_t due = due_time(url);
+	return !due || now >= due;
+}
+
+
+time_t PollStore::due_time(std::string_view url){
+	std::lock_guard<std::mutex> guard(lock);
+	auto feed = this->feeds.find(url);
+	return feed == this->feeds.end() ? 0 : feed->second.checked + static_cast<time_t>(feed->second.interval);
+}
+
+
+double PollStore::estimate(std::vector<time_t> times){
+	// average gap between newest entries, repeated timestamps are counted once
+	std::sort(times.begin(), times.end(), std::greater<time_t>());
+	times.erase(std::unique(times.begin(), times.end()), times.end());
+	if (times.size() > POLL_HISTORY)
+		times.resize(POLL_HISTORY);
+	if (times.size() < 2)
+		return 0;
+	return static_cast<double>(times.front() - times.back()) / (times.size() - 1);
+}
+
+
+void PollStore::update(std::string_view url, struct poll_sample &sample, time_t now){
+	double gap = estimate(sample.times);
+
+	std::lock_guard<std::mutex> guard(lock);
+	auto feed = this->feeds.find(url);
+	if (feed == this->feeds.end()){
+		double interval = gap ? gap : POLL_DEFAULT;
+		this->feeds[std::string(url)] = {now, std::min<double>(POLL_MAX, std::max<double>(POLL_MIN, interval)), sample.digest};
+		return;
+	}
+
+	struct state &state = feed->second;
+	if (sample.digest == state.digest)
+		state.interval *= POLL_BACKOFF;
+	else {
+		// feed changed some time since last check, without timestamps of entries the middle
+		// of that time is taken, feed is checked only once due, so whole time would never shorten interval
+		if (!gap)
+			gap = static_cast<double>(now - state.checked) / 2;
+		state.interval = (state.interval + gap) / 2;
+	}
+	state.interval = std::min<double>(POLL_MAX, std::max<double>(POLL_MIN, state.interval));
+	state.checked = now;
+	state.digest = sample.digest;
+}
+
+
+void PollStore::observe(struct poll_sample &sample, std::string_view key, std::string_view timestamp){
+	uint64_t hash = FNV_OFFSET;
+	for (char c : key)
+		hash = (hash ^ static_cast<unsigned char>(c)) * FNV_PRIME;
+	// order of entries matters, rotation keeps it in fingerprint
+	sample.digest = ((sample.digest << 7) | (sample.digest >> 57)) ^ hash;
+
+	time_t time = parse_time(timestamp);
+	if (time)
+		sample.times.push_back(time);
+}
+
+
+// read number of at most max digits, returns false if there is none
+static bool read_number(std::string_view &text, int max, int &value){
+	int digits = 0;
+	value = 0;
+	while (digits < max && digits < static_cast<int>(text.size()) && isdigit(static_cast<unsigned char>(text[digits])))
+		value = value * 10 + (text[digits++] - '0');
+	text.remove_prefix(digits);
+	return digits > 0;
+}
+
+
+// skip character c if it is next in text
+static bool skip_char(std::string_view &text, char c){
+	if (text.empty() || text[0] != c)
+		return false;
+	text.remove_prefix(1);
+	return true;
+}
+
+
+// skip white space
+static void skip_blank(std::string_view &text){
+	while (!text.empty() && isspace(static_cast<unsigned char>(text[0])))
+		text.remove_prefix(1);
+}
+
+
+// read time zone offset in seconds: Z, +hh:mm, +hhmm or name of RFC 822 zone, missing zone is UTC
+static bool read_zone(std::string_view &text, long &offset){
+	static const struct {
+		const char *name;
+		int hours;
+	} ZONES[] = {
+		{"GMT", 0}, {"UTC", 0}, {"UT", 0}, {"Z", 0},
+		{"EST", -5}, {"EDT", -4}, {"CST", -6}, {"CDT", -5},
+		{"MST", -7}, {"MDT", -6}, {"PST", -8}, {"PDT", -7},
+	};
+
+	offset = 0;
+	skip_blank(text);
+	if (text.empty())
+		return true;
+	if (text[0] == '+' || text[0] == '-'){
+		int sign = text[0] == '-' ? -1 : 1;
+		text.remove_prefix(1);
+		int hours, minutes = 0;
+		if (!read_number(text, 2, hours))
+			return false;
+		skip_char(text, ':');
+		read_number(text, 2, minutes);
+		offset = sign * (hours * 3600L + minutes * 60L);
+		return true;
+	}
+	for (auto &zone : ZONES){
+		size_t length = strlen(zone.name);
+		if (text.size() >= length && !strncasecmp(text.data(), zone.name, length)){
+			offset = zone.hours * 3600L;
+			return true;
+		}
+	}
+	return false;
+}
+
+
+time_t PollStore::parse_time(std::string_view text){
+	static const char *MONTHS[] = {"jan", "feb", "mar", "apr", "may", "jun", "jul", "aug", "sep", "oct", "nov", "dec"};
+	struct tm tm = {};
+	int year, month, day, hour = 0, minute = 0, second = 0;
+	long offset = 0;
+
+	skip_blank(text);
+	if (text.size() >= 5 && text[4] == '-'){
+		// RFC 3339: 2026-10-17T08:30:00.000+02:00, time may be left out
+		if (!read_number(text, 4, year) || !skip_char(text, '-') || !read_number(text, 2, month)
+			|| !skip_char(text, '-') || !read_number(text, 2, day))
+			return 0;
+		if (skip_char(text, 'T') || skip_char(text, 't') || skip_char(text, ' ')){
+			if (!read_number(text, 2, hour) || !skip_char(text, ':') || !read_number(text, 2, minute))
+				return 0;
+			if (skip_char(text, ':') && !read_number(text, 2, second))
+				return 0;
+			// fraction of second
+			if (skip_char(text, '.'))
+				while (!text.empty() && isdigit(static_cast<unsigned char>(text[0])))
+					text.remove_prefix(1);
+			if (!read_zone(text, offset))
+				return 0;
+		}
+	}
+	else {
+		// RFC 822: Sat, 17 Oct 2026 08:30:00 +0200, name of day and seconds are optional
+		size_t comma = text.find(',');
+		if (comma != std::string_view::npos && comma < 10)
+			text.remove_prefix(comma + 1);
+		skip_blank(text);
+		if (!read_number(text, 2, day))
+			return 0;
+		skip_blank(text);
+		month = 0;
+		for (int i = 0; i < 12 && !month; i++)
+			if (text.size() >= 3 && !strncasecmp(text.data(), MONTHS[i], 3))
+				month = i + 1;
+		if (!month)
+			return 0;
+		while (!text.empty() && isalpha(static_cast<unsigned char>(text[0])))
+			text.remove_prefix(1);
+		skip_blank(text);
+		if (!read_number(text, 4, year))
+			return 0;
+		// two digit year of RFC 822
+		if (year < 100)
+			year += year < 70 ? 2000 : 1900;
+		skip_blank(text);
+		if (read_number(text, 2, hour)){
+			if (!skip_char(text, ':') || !read_number(text, 2, minute))
+				return 0;
+			if (skip_char(text, ':') && !read_number(text, 2, second))
+				return 0;
+			if (!read_zone(text, offset))
+				return 0;
+		}
+	}
+
+	if (month < 1 || month > 12 || day < 1 || day > 31 || hour > 23 || minute > 59 || second > 60 || year < 1970)
+		return 0;
+	tm.tm_year = year - 1900;
+	tm.tm_mon = month - 1;
+	tm.tm_mday = day;
+	tm.tm_hour = hour;
+	tm.tm_min = minute;
+	tm.tm_sec = second;
+	time_t time = timegm(&tm);
+	return time == -1 ? 0 : time - offset;
+}
@@ -0,0 +1,145 @@
+/*
+ * resolver.cpp
+ *
+ * Asynchronous resolution of host names with per-run cache of results.
+ *
+ * Project: Reader of news feed in format Atom & RSS with support of TLS
+ * Author: Matus Remen (xremen01@stud.fit.vutbr.cz)
+ * Date: 17.10.2026
+ */
+
+#include <chrono>
+#include <thread>
+#include <cstring>
+#include <netdb.h>
+#include "../include/resolver.hpp"
+
+
+Resolver::Resolver() : Resolver(system_lookup){}
+
+
+Resolver::Resolver(lookup_function lookup){
+	this->shared = std::make_shared<struct state>();
+	this->shared->threads = 0;
+	this->shared->lookup = lookup;
+}
+
+
+Resolver::~Resolver(){
+	// background threads still running keep their own reference of shared state
+	std::lock_guard<std::mutex> guard(shared->lock);
+	shared->queue.clear();
+}
+
+
+bool Resolver::system_lookup(const std::string &host, std::vector<struct address> &addresses){
+	struct addrinfo hints;
+	struct addrinfo *result = nullptr;
+	memset(&hints, 0, sizeof(hints));
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+
+	if (getaddrinfo(host.c_str(), nullptr, &hints, &result) != 0)
+		return false;
+
+	// addresses are kept in order of preference given by system (RFC 6724)
+	for (struct addrinfo *ai = result; ai; ai = ai->ai_next){
+		if ((ai->ai_family != AF_INET && ai->ai_family != AF_INET6) || ai->ai_addrlen > sizeof(struct sockaddr_storage))
+			continue;
+		struct address addr;
+		memset(&addr, 0, sizeof(addr));
+		memcpy(&addr.addr, ai->ai_addr, ai->ai_addrlen);
+		addr.length = ai->ai_addrlen;
+		addresses.push_back(addr);
+	}
+	freeaddrinfo(result);
+
+	return !addresses.empty();
+}
+
+
+void Resolver::run_lookup(std::shared_ptr<struct state> shared, const std::string &host){
+	std::vector<struct address> addresses;
+	bool ok = shared->lookup(host, addresses);
+
+	{
+		std::lock_guard<std::mutex> guard(shared->lock);
+		struct entry &entry = shared->entries[host];
+		entry.done = true;
+		entry.ok = ok;
+		entry.addresses = std::move(addresses);
+	}
+	shared->resolved.notify_all();
+}
+
+
+void Resolver::lookup_thread(std::shared_ptr<struct state> shared){
+	while (true){
+		std::string host;
+		{
+			std::lock_guard<std::mutex> guard(shared->lock);
+			// names already taken by clients waiting for them are skipped
+			while (!shared->queue.empty() && shared->entries[shared->queue.front()].started)
+				shared->queue.pop_front();
+			if (shared->queue.empty()){
+				shared->threads--;
+				return;
+			}
+			host = shared->queue.front();
+			shared->queue.pop_front();
+			shared->entries[host].started = true;
+		}
+
+		run_lookup(shared, host);
+	}
+}
+
+
+void Resolver::prefetch(std::string host){
+	std::lock_guard<std::mutex> guard(shared->lock);
+	if (shared->entries.count(host))
+		return;
+
+	shared->entries[host] = {false, false, false, {}};
+	shared->queue.push_back(host);
+	if (shared->threads < RESOLVE_JOBS){
+		shared->threads++;
+		std::thread(lookup_thread, shared).detach();
+	}
+}
+
+
+bool Resolver::resolve(std::string host, std::vector<struct address> &addresses, int timeout){
+	std::unique_lock<std::mutex> guard(shared->lock);
+	auto done = [&]{ return shared->entries[host].done; };
+	if (!shared->entries[host].started){
+		shared->entries[host].started = true;
+		if (timeout < 0){
+			// name which is not being resolved yet is resolved right away by calling thread
+			guard.unlock();
+			run_lookup(shared, host);
+			guard.lock();
+		}
+		else
+			// lookup can't be interrupted, caller gives up waiting for it instead
+			std::thread(run_lookup, shared, host).detach();
+	}
+
+	if (timeout < 0)
+		shared->resolved.wait(guard, done);
+	else if (!shared->resolved.wait_for(guard, std::chrono::milliseconds(timeout), done))
+		return false;
+	addresses = shared->entries[host].addresses;
+	return shared->entries[host].ok;
+}
+
+
+void Resolver::forget(){
+	std::lock_guard<std::mutex> guard(shared->lock);
+	for (auto entry = shared->entries.begin(); entry != shared->entries.end();){
+		if (entry->second.done)
+			entry = shared->entries.erase(entry);
+		else
+			entry++;
+	}
+}
@@ -0,0 +1,178 @@
+/*
+ * scheduler.cpp
+ *
+ * Order of requests with per-host limits and priorities.
+ *
+ * Project: Reader of news feed in format Atom & RSS with support of TLS
+ * Author: Matus Remen (xremen01@stud.fit.vutbr.cz)
+ * Date: 17.10.2026
+ */
+
+#include <cctype>
+#include <algorithm>
+#include <unordered_map>
+#include "../include/scheduler.hpp"
+#include "../include/url.hpp"
+
+
+Scheduler::Scheduler(){
+	this->count = 0;
+	this->window = 0;
+	this->admitted = 0;
+	this->horizon = 0;
+	this->taken = 0;
+	this->turn = 0;
+}
+
+
+Scheduler::~Scheduler(){}
+
+
+void Scheduler::set_limits(struct host_limits limits){
+	std::lock_guard<std::mutex> guard(lock);
+	this->limits = limits;
+}
+
+
+std::string Scheduler::authority(std::string_view url){
+	struct url_view parts;
+	if (!scan_url(url, parts))
+		return std::string();
+
+	// host names are case insensitive, default port is the one of scheme (see Client::PORT_MAP)
+	std::string key;
+	key.reserve(parts.host.size() + 6);
+	for (char c : parts.host)
+		key += static_cast<char>(tolower(static_cast<unsigned char>(c)));
+	key += ':';
+	if (!parts.port.empty())
+		key.append(parts.port);
+	else if (parts.scheme == "https")
+		key += "443";
+	else
+		key += "80";
+	return key;
+}
+
+
+void Scheduler::start(const std::vector<std::string_view> &urls, const std::vector<long> &priorities, size_t window){
+	std::lock_guard<std::mutex> guard(lock);
+	this->count = urls.size();
+	this->window = window;
+	this->admitted = 0;
+	this->horizon = window ? window : urls.size();
+	this->taken = 0;
+	this->turn = 0;
+	this->priorities = priorities;
+	this->priorities.resize(urls.size(), 0);
+	this->pending.clear();
+
+	// urls of the same host are mapped to one state
+	std::unordered_map<std::string, size_t> index;
+	auto now = std::chrono::steady_clock::now();
+	this->hosts.clear();
+	this->host_of.resize(urls.size());
+	for (size_t idx = 0; idx < urls.size(); idx++){
+		auto found = index.emplace(authority(urls[idx]), this->hosts.size());
+		if (found.second)
+			this->hosts.push_back({0, static_cast<double>(std::max(1u, this->limits.burst)), now, 0, {}});
+		this->host_of[idx] = found.first->second;
+	}
+}
+
+
+void Scheduler::admit(){
+	size_t end = std::min(this->horizon, this->count);
+	for (; this->admitted < end; this->admitted++){
+		struct host &host = this->hosts[this->host_of[this->admitted]];
+		if (host.queue.empty())
+			this->pending.push_back(this->host_of[this->admitted]);
+		host.queue.emplace(this->priorities[this->admitted], this->admitted);
+	}
+}
+
+
+void Scheduler::refill(struct host &host, std::chrono::steady_clock::time_point now){
+	std::chrono::duration<double> elapsed = now - host.refilled;
+	host.tokens = std::min<double>(std::max(1u, this->limits.burst), host.tokens + elapsed.count() * this->limits.rate);
+	host.refilled = now;
+}
+
+
+bool Scheduler::take(size_t &idx){
+	std::unique_lock<std::mutex> guard(lock);
+	while (true){
+		if (this->taken >= this->count)
+			return false;
+		admit();
+
+		auto now = std::chrono::steady_clock::now();
+		auto wake = std::chrono::steady_clock::time_point::max();
+		size_t best = this->pending.size();
+		for (size_t i = 0; i < this->pending.size(); i++){
+			struct host &host = this->hosts[this->pending[i]];
+			if (this->limits.connections && host.active >= this->limits.connections)
+				continue;
+			if (this->limits.rate > 0){
+				refill(host, now);
+				if (host.tokens < 1){
+					// time when host earns its next token
+					auto ready = now + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+						std::chrono::duration<double>((1 - host.tokens) / this->limits.rate));
+					wake = std::min(wake, ready);
+					continue;
+				}
+			}
+			if (best == this->pending.size())
+				best = i;
+			else {
+				struct host &other = this->hosts[this->pending[best]];
+				long priority = host.queue.begin()->first, other_priority = other.queue.begin()->first;
+				if (priority < other_priority || (priority == other_priority && host.served < other.served))
+					best = i;
+			}
+		}
+
+		if (best < this->pending.size()){
+			struct host &host = this->hosts[this->pending[best]];
+			idx = host.queue.begin()->second;
+			host.queue.erase(host.queue.begin());
+			if (host.queue.empty()){
+				this->pending[best] = this->pending.back();
+				this->pending.pop_back();
+			}
+			host.active++;
+			if (this->limits.rate > 0)
+				host.tokens -= 1;
+			host.served = ++this->turn;
+			this->taken++;
+			return true;
+		}
+
+		// every waiting url is held back by limit of its host or by window
+		if (wake != std::chrono::steady_clock::time_point::max())
+			this->changed.wait_until(guard, wake);
+		else
+			this->changed.wait(guard);
+	}
+}
+
+
+void Scheduler::done(size_t idx){
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		this->hosts[this->host_of[idx]].active--;
+	}
+	this->changed.notify_all();
+}
+
+
+void Scheduler::advance(size_t consumed){
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		if (!this->window || consumed + this->window <= this->horizon)
+			return;
+		this->horizon = consumed + this->window;
+	}
+	this->changed.notify_all();
+}
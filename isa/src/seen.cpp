@@ -0,0 +1,191 @@
+/*
+ * seen.cpp
+ *
+ * Persistent store of feed entries printed by previous runs.
+ *
+ * Project: Reader of news feed in format Atom & RSS with support of TLS
+ * Author: Matus Remen (xremen01@stud.fit.vutbr.cz)
+ * Date: 17.10.2026
+ */
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "../include/seen.hpp"
+
+
+SeenStore::SeenStore(){
+	this->fd = -1;
+	this->table = nullptr;
+	this->size = 0;
+}
+
+
+SeenStore::~SeenStore(){
+	unmap();
+}
+
+
+uint64_t SeenStore::fingerprint(std::string_view feed, std::string_view id){
+	// FNV-1a over both strings with separator, finished by avalanche step of splitmix64
+	uint64_t hash = 0xcbf29ce484222325ULL;
+	for (unsigned char c : feed)
+		hash = (hash ^ c) * 0x100000001b3ULL;
+	hash = (hash ^ 0xff) * 0x100000001b3ULL;
+	for (unsigned char c : id)
+		hash = (hash ^ c) * 0x100000001b3ULL;
+
+	hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebULL;
+	hash ^= hash >> 31;
+	return hash ? hash : 1;
+}
+
+
+bool SeenStore::create(std::string file, uint64_t capacity){
+	this->fd = ::open(file.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+	if (this->fd < 0)
+		return false;
+
+	// file is sparse, untouched slots read as zeros
+	size_t size = sizeof(struct header) + capacity * sizeof(uint64_t);
+	struct header head;
+	memset(&head, 0, sizeof(head));
+	memcpy(head.magic, SEEN_MAGIC, sizeof(SEEN_MAGIC));
+	head.capacity = capacity;
+	head.count = 0;
+	if (ftruncate(this->fd, size) || pwrite(this->fd, &head, sizeof(head), 0) != sizeof(head)){
+		unmap();
+		return false;
+	}
+	if (!map()){
+		unmap();
+		return false;
+	}
+	return true;
+}
+
+
+bool SeenStore::map(){
+	struct stat info;
+	struct header head;
+	if (fstat(this->fd, &info) || pread(this->fd, &head, sizeof(head), 0) != sizeof(head))
+		return false;
+
+	// capacity must be power of two and match size of file
+	if (memcmp(head.magic, SEEN_MAGIC, sizeof(SEEN_MAGIC)) || !head.capacity || (head.capacity & (head.capacity - 1))
+		|| head.capacity > (uint64_t)info.st_size / sizeof(uint64_t)
+		|| (uint64_t)info.st_size != sizeof(struct header) + head.capacity * sizeof(uint64_t))
+		return false;
+
+	void *mapped = mmap(nullptr, info.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, this->fd, 0);
+	if (mapped == MAP_FAILED)
+		return false;
+	this->table = static_cast<struct header *>(mapped);
+	this->size = info.st_size;
+	return true;
+}
+
+
+void SeenStore::unmap(){
+	if (this->table)
+		munmap(this->table, this->size);
+	if (this->fd >= 0)
+		close(this->fd);
+	this->table = nullptr;
+	this->size = 0;
+	this->fd = -1;
+}
+
+
+bool SeenStore::open(std::string path){
+	std::lock_guard<std::mutex> guard(lock);
+	unmap();
+	this->path = path;
+
+	this->fd = ::open(path.c_str(), O_RDWR | O_CLOEXEC);
+	if (this->fd < 0)
+		return errno == ENOENT && create(path, SEEN_CAPACITY);
+	if (!map()){
+		unmap();
+		return false;
+	}
+	return true;
+}
+
+
+bool SeenStore::insert(uint64_t key){
+	uint64_t mask = this->table->capacity - 1;
+	uint64_t *slot = slots();
+	for (uint64_t i = key & mask; ; i = (i + 1) & mask){
+		if (slot[i] == key)
+			return false;
+		if (!slot[i]){
+			slot[i] = key;
+			this->table->count++;
+			return true;
+		}
+	}
+}
+
+
+bool SeenStore::grow(){
+	struct header *old_table = this->table;
+	size_t old_size = this->size;
+	int old_fd = this->fd;
+	std::string tmp = this->path + ".tmp";
+
+	this->table = nullptr;
+	this->fd = -1;
+	if (!create(tmp, old_table->capacity * 2)){
+		unlink(tmp.c_str());
+		this->table = old_table;
+		this->size = old_size;
+		this->fd = old_fd;
+		return false;
+	}
+
+	uint64_t *old_slots = reinterpret_cast<uint64_t *>(old_table + 1);
+	for (uint64_t i = 0; i < old_table->capacity; i++)
+		if (old_slots[i])
+			insert(old_slots[i]);
+
+	// table which is not in place of store is thrown away, old one is used further
+	if (rename(tmp.c_str(), this->path.c_str())){
+		unmap();
+		unlink(tmp.c_str());
+		this->table = old_table;
+		this->size = old_size;
+		this->fd = old_fd;
+		return false;
+	}
+	munmap(old_table, old_size);
+	close(old_fd);
+	return true;
+}
+
+
+bool SeenStore::add(std::string_view feed, std::string_view id){
+	uint64_t key = fingerprint(feed, id);
+	std::lock_guard<std::mutex> guard(lock);
+	if (!this->table)
+		return true;
+
+	// table is kept at most three quarters full, so probing sequences stay short
+	if ((this->table->count + 1) * 4 > this->table->capacity * 3)
+		grow();
+	// full table can't hold more, entry is reported as new
+	if (this->table->count + 1 >= this->table->capacity)
+		return true;
+	return insert(key);
+}
+
+
+uint64_t SeenStore::count(){
+	std::lock_guard<std::mutex> guard(lock);
+	return this->table ? this->table->count : 0;
+}
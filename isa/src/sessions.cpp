@@ -0,0 +1,133 @@
+/*
+ * sessions.cpp
+ *
+ * Cache of TLS sessions for resumption of handshakes with already visited hosts.
+ *
+ * Project: Reader of news feed in format Atom & RSS with support of TLS
+ * Author: Matus Remen (xremen01@stud.fit.vutbr.cz)
+ * Date: 17.10.2026
+ */
+
+#include <ctime>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstdio>
+#include <openssl/pem.h>
+#include "../include/sessions.hpp"
+
+
+SessionCache::SessionCache(){}
+
+
+SessionCache::~SessionCache(){
+	for (auto &entry : sessions)
+		SSL_SESSION_free(entry.second);
+}
+
+
+bool SessionCache::alive(SSL_SESSION *session){
+	if (!SSL_SESSION_is_resumable(session))
+		return false;
+	return SSL_SESSION_get_time(session) + SSL_SESSION_get_timeout(session) > time(nullptr);
+}
+
+
+SSL_SESSION *SessionCache::get(std::string authority){
+	std::lock_guard<std::mutex> guard(lock);
+
+	auto entry = sessions.find(authority);
+	if (entry == sessions.end())
+		return nullptr;
+
+	if (!alive(entry->second)){
+		SSL_SESSION_free(entry->second);
+		sessions.erase(entry);
+		return nullptr;
+	}
+
+	SSL_SESSION_up_ref(entry->second);
+	return entry->second;
+}
+
+
+void SessionCache::put(std::string authority, SSL_SESSION *session){
+	if (!session)
+		return;
+	if (!alive(session)){
+		SSL_SESSION_free(session);
+		return;
+	}
+
+	std::lock_guard<std::mutex> guard(lock);
+
+	auto entry = sessions.find(authority);
+	if (entry != sessions.end()){
+		SSL_SESSION_free(entry->second);
+		entry->second = session;
+	}
+	else {
+		sessions[authority] = session;
+	}
+}
+
+
+bool SessionCache::load(std::string path){
+	BIO *file = BIO_new_file(path.c_str(), "r");
+	if (!file)
+		return false;
+
+	// file consists of records: line with authority followed by PEM encoded session
+	char line[1024];
+	while (BIO_gets(file, line, sizeof(line)) > 0){
+		std::string authority(line);
+		while (!authority.empty() && (authority.back() == '\n' || authority.back() == '\r'))
+			authority.pop_back();
+		if (authority.empty())
+			continue;
+
+		SSL_SESSION *session = PEM_read_bio_SSL_SESSION(file, nullptr, nullptr, nullptr);
+		if (!session)
+			break;
+		put(authority, session);
+	}
+
+	BIO_free(file);
+	return true;
+}
+
+
+bool SessionCache::save(std::string path){
+	// sessions hold master secrets, only owner may read them, previous file is kept until
+	// new one is complete
+	std::string tmp = path + ".tmp";
+	int fd = open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+	if (fd < 0)
+		return false;
+	BIO *file = BIO_new_fd(fd, BIO_CLOSE);
+	if (!file){
+		close(fd);
+		unlink(tmp.c_str());
+		return false;
+	}
+
+	bool ok = true;
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		for (auto &entry : sessions){
+			if (!alive(entry.second))
+				continue;
+			if (BIO_printf(file, "%s\n", entry.first.c_str()) <= 0 || !PEM_write_bio_SSL_SESSION(file, entry.second)){
+				ok = false;
+				break;
+			}
+		}
+	}
+
+	ok = BIO_flush(file) == 1 && ok;
+	BIO_free(file);
+	if (!ok || rename(tmp.c_str(), path.c_str())){
+		unlink(tmp.c_str());
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,177 @@
+/*
+ * sink.cpp
+ *
+ * Output formats of parsed feed messages.
+ *
+ * Project: Reader of news feed in format Atom & RSS with support of TLS
+ * Author: Matus Remen (xremen01@stud.fit.vutbr.cz)
+ * Date: 17.10.2026
+ */
+
+#include <cstdint>
+#include "../include/sink.hpp"
+
+
+Sink::~Sink(){}
+
+
+void Sink::header(std::ostream &){}
+
+
+void Sink::separator(std::ostream &){}
+
+
+void Sink::feed(std::ostream &, std::string_view, std::string_view){}
+
+
+std::unique_ptr<Sink> Sink::create(std::string format, char filter){
+	if (format == "text")
+		return std::unique_ptr<Sink>(new TextSink(filter));
+	if (format == "jsonl")
+		return std::unique_ptr<Sink>(new JsonSink());
+	if (format == "csv")
+		return std::unique_ptr<Sink>(new CsvSink());
+	if (format == "binary")
+		return std::unique_ptr<Sink>(new BinarySink());
+	return nullptr;
+}
+
+
+TextSink::TextSink(char filter){
+	this->filter = filter;
+}
+
+
+void TextSink::separator(std::ostream &out){
+	out << '\n';
+}
+
+
+void TextSink::feed(std::ostream &out, std::string_view, std::string_view title){
+	out << "*** " << title << " ***\n";
+}
+
+
+void TextSink::message(std::ostream &out, const struct entry &e, int idx){
+	if (idx && filter && (!e.timestamp.empty() || !e.author.empty() || !e.reference.empty()))
+		out << '\n';
+	out << e.title << '\n';
+	if (filter & _TS_OPT && !e.timestamp.empty())
+		out << "Aktualizace: " << e.timestamp << '\n';
+	if (filter & _AU_OPT && !e.author.empty())
+		out << "Autor: " << e.author << '\n';
+	if (filter & _REF_OPT && !e.reference.empty())
+		out << "URL: " << e.reference << '\n';
+}
+
+
+void JsonSink::write_string(std::ostream &out, std::string_view str){
+	static const char hex[] = "0123456789abcdef";
+	out << '"';
+	size_t start = 0;
+	for (size_t i = 0; i < str.size(); i++){
+		unsigned char c = str[i];
+		if (c >= 0x20 && c != '"' && c != '\\')
+			continue;
+
+		// unescaped run is written at once
+		out.write(str.data() + start, i - start);
+		start = i + 1;
+		switch (c){
+			case '"': out << "\\\""; break;
+			case '\\': out << "\\\\"; break;
+			case '\n': out << "\\n"; break;
+			case '\r': out << "\\r"; break;
+			case '\t': out << "\\t"; break;
+			default:
+				out << "\\u00" << hex[c >> 4] << hex[c & 0xf];
+		}
+	}
+	out.write(str.data() + start, str.size() - start);
+	out << '"';
+}
+
+
+void JsonSink::message(std::ostream &out, const struct entry &e, int){
+	out << "{\"feed\":";
+	write_string(out, e.feed);
+	out << ",\"feed_title\":";
+	write_string(out, e.feed_title);
+	out << ",\"title\":";
+	write_string(out, e.title);
+	out << ",\"updated\":";
+	write_string(out, e.timestamp);
+	out << ",\"author\":";
+	write_string(out, e.author);
+	out << ",\"link\":";
+	write_string(out, e.reference);
+	out << "}\n";
+}
+
+
+void CsvSink::write_field(std::ostream &out, std::string_view field){
+	if (field.find_first_of(",\"\r\n") == std::string_view::npos){
+		out << field;
+		return;
+	}
+
+	// quotes inside quoted field are doubled
+	out << '"';
+	size_t start = 0;
+	for (size_t quote = field.find('"'); quote != std::string_view::npos; quote = field.find('"', start)){
+		out.write(field.data() + start, quote - start + 1);
+		out << '"';
+		start = quote + 1;
+	}
+	out.write(field.data() + start, field.size() - start);
+	out << '"';
+}
+
+
+void CsvSink::header(std::ostream &out){
+	out << "feed,feed_title,title,updated,author,link\r\n";
+}
+
+
+void CsvSink::message(std::ostream &out, const struct entry &e, int){
+	write_field(out, e.feed);
+	out << ',';
+	write_field(out, e.feed_title);
+	out << ',';
+	write_field(out, e.title);
+	out << ',';
+	write_field(out, e.timestamp);
+	out << ',';
+	write_field(out, e.author);
+	out << ',';
+	write_field(out, e.reference);
+	out << "\r\n";
+}
+
+
+void BinarySink::write_u32(std::ostream &out, uint32_t value){
+	char bytes[4] = {
+		static_cast<char>(value & 0xff), static_cast<char>((value >> 8) & 0xff),
+		static_cast<char>((value >> 16) & 0xff), static_cast<char>((value >> 24) & 0xff)
+	};
+	out.write(bytes, 4);
+}
+
+
+void BinarySink::header(std::ostream &out){
+	out.write(BINARY_MAGIC, 8);
+}
+
+
+void BinarySink::message(std::ostream &out, const struct entry &e, int){
+	std::string_view fields[] = {e.feed, e.feed_title, e.title, e.timestamp, e.author, e.reference};
+	uint32_t length = 0;
+	for (std::string_view field : fields)
+		length += 4 + field.size();
+
+	write_u32(out, length);
+	for (std::string_view field : fields){
+		write_u32(out, field.size());
+		out.write(field.data(), field.size());
+	}
+}
@@ -0,0 +1,316 @@
+/*
+ * stream.cpp
+ *
+ * Streaming parser of Atom & RSS2.0 feeds built on libxml2 push parser.
+ *
+ * Project: Reader of news feed in format Atom & RSS with support of TLS
+ * Author: Matus Remen (xremen01@stud.fit.vutbr.cz)
+ * Date: 17.10.2026
+ */
+
+#include <cstring>
+#include <iostream>
+#include "../include/json.hpp"
+#include "../include/stream.hpp"
+
+
+StreamParser::StreamParser(bool _ts, bool _au, bool _ref, std::ostream &out) : out(out){
+	this->filter = 0;
+	this->filter |= (_ts ? _TS_OPT : 0);
+	this->filter |= (_au ? _AU_OPT : 0);
+	this->filter |= (_ref ? _REF_OPT : 0);
+	this->seen = nullptr;
+	this->poll = nullptr;
+	this->text_sink = std::unique_ptr<Sink>(new TextSink(this->filter));
+	this->sink = this->text_sink.get();
+
+	this->format = nullptr;
+	this->started = false;
+	this->failed = false;
+	this->done = false;
+	this->depth = 0;
+	this->channel_depth = 0;
+	this->channel_open = false;
+	this->entry_depth = 0;
+	this->json = false;
+	this->title_found = false;
+	this->title_printed = false;
+	this->in_entry = false;
+	this->idx = 0;
+	this->capture = nullptr;
+	this->capture_depth = 0;
+
+	// default SAX2 handlers keep doctype and entity declarations, so entities of internal subset
+	// are expanded, elements are handled here and no tree is built
+	xmlSAXHandler sax;
+	memset(&sax, 0, sizeof(sax));
+	xmlSAXVersion(&sax, 2);
+	sax.startElementNs = on_start;
+	sax.endElementNs = on_end;
+	sax.characters = on_text;
+	sax.cdataBlock = on_text;
+	sax.reference = nullptr;
+	// errors are not printed, streamed documents are often cut off or followed by garbage
+	sax.warning = nullptr;
+	sax.error = nullptr;
+	sax.fatalError = nullptr;
+
+	// default handlers need parser context as their ctx, parser object is reached through it
+	this->context = xmlCreatePushParserCtxt(&sax, nullptr, nullptr, 0, nullptr);
+	if (!this->context)
+		this->failed = true;
+	else
+		this->context->_private = this;
+}
+
+
+StreamParser::~StreamParser(){
+	if (this->context){
+		xmlFreeDoc(this->context->myDoc);
+		xmlFreeParserCtxt(this->context);
+	}
+}
+
+
+void StreamParser::set_seen_store(SeenStore *seen, std::string url){
+	this->seen = seen;
+	this->url = url;
+}
+
+
+void StreamParser::set_poll_store(PollStore *poll, std::string url){
+	this->poll = poll;
+	this->url = url;
+}
+
+
+void StreamParser::set_sink(Sink *sink, std::string url){
+	this->sink = sink ? sink : this->text_sink.get();
+	this->url = url;
+}
+
+
+void StreamParser::print_message(struct message &msg){
+	struct entry e = {this->url, this->feed_title, msg.title, msg.timestamp, msg.author, msg.reference};
+	this->sink->message(this->out, e, this->idx++);
+}
+
+
+void StreamParser::capture_text(std::string *target){
+	target->clear();
+	this->capture = target;
+	this->capture_depth = this->depth;
+}
+
+
+void StreamParser::emit_message(){
+	std::string *f = this->fields;
+	if (this->poll)
+		PollStore::observe(this->sample, Parser::entry_key(f[FIELD_ID], f[FIELD_REFERENCE], f[FIELD_TITLE]), f[FIELD_TIMESTAMP]);
+	if (f[FIELD_TITLE].empty())
+		return;
+	if (this->seen && !this->seen->add(this->url, Parser::entry_key(f[FIELD_ID], f[FIELD_REFERENCE], f[FIELD_TITLE])))
+		return;
+
+	struct message msg = {f[FIELD_TITLE], f[FIELD_TIMESTAMP], f[FIELD_AUTHOR], f[FIELD_REFERENCE]};
+	if (!this->title_printed){
+		pending.push_back(msg);
+		return;
+	}
+	print_message(msg);
+}
+
+
+void StreamParser::emit_title(){
+	if (this->title_printed)
+		return;
+	this->title_printed = true;
+
+	if (this->title_found)
+		this->sink->feed(this->out, this->url, this->feed_title);
+	for (struct message &msg : pending)
+		print_message(msg);
+	pending.clear();
+}
+
+
+bool StreamParser::emit_json(){
+	Arena arena;
+	JsonFeed feed;
+	if (!feed.read(this->json_data, arena)){
+		std::cerr << "Invalid JSON feed." << std::endl;
+		return false;
+	}
+
+	if (!feed.title.empty()){
+		this->feed_title = std::string(feed.title);
+		this->title_found = true;
+	}
+	emit_title();
+	for (struct record &item : feed.items){
+		for (int i = 0; i < FIELD_COUNT; i++)
+			this->fields[i] = std::string(item.fields[i]);
+		emit_message();
+	}
+	return true;
+}
+
+
+void StreamParser::on_start(void *ctx, const xmlChar *name, const xmlChar *, const xmlChar *,
+	int, const xmlChar **, int nb_attributes, int, const xmlChar **attributes){
+	StreamParser *self = static_cast<StreamParser *>(static_cast<xmlParserCtxtPtr>(ctx)->_private);
+	int depth = ++self->depth;
+	enum tag tag = self->tags.lookup(name);
+
+	// root element decides the format
+	if (depth == 1){
+		self->format = format_by_root(tag);
+		if (self->format && self->format->channel == TAG_OTHER){
+			self->channel_depth = self->entry_depth = 1;
+			self->channel_open = true;
+		}
+		else if (self->format && self->format->entries_in_root)
+			self->entry_depth = 1;
+		return;
+	}
+	if (!self->format)
+		return;
+
+	// only first channel of document is read
+	if (depth == 2 && !self->channel_depth && tag == self->format->channel){
+		self->channel_depth = 2;
+		self->channel_open = true;
+		if (!self->format->entries_in_root)
+			self->entry_depth = 2;
+		return;
+	}
+
+	if (self->capture)
+		return;
+
+	// feed title
+	if (self->channel_open && depth == self->channel_depth + 1 && !self->in_entry && tag == TAG_TITLE && !self->title_found){
+		self->capture_text(&self->feed_title);
+		return;
+	}
+
+	// message
+	if (self->entry_depth && depth == self->entry_depth + 1){
+		if (tag == self->format->entry){
+			self->in_entry = true;
+			for (std::string &field : self->fields)
+				field.clear();
+		}
+		return;
+	}
+
+	// message fields
+	if (!self->in_entry || depth != self->entry_depth + 2)
+		return;
+	const struct field_rule *rule = find_rule(self->format->id, tag);
+	if (!rule || (rule->fallback && !self->fields[rule->field].empty()))
+		return;
+	if (!rule->attr){
+		self->capture_text(&self->fields[rule->field]);
+		return;
+	}
+	// attributes come in quintuples: localname, prefix, URI, value, end of value
+	for (int i = 0; i < nb_attributes; i++){
+		const xmlChar **attr = attributes + 5 * i;
+		if (!xmlStrcmp(attr[0], (xmlChar *) rule->attr))
+			self->fields[rule->field] = std::string((const char *) attr[3], attr[4] - attr[3]);
+	}
+}
+
+
+void StreamParser::on_end(void *ctx, const xmlChar *, const xmlChar *, const xmlChar *){
+	StreamParser *self = static_cast<StreamParser *>(static_cast<xmlParserCtxtPtr>(ctx)->_private);
+	int depth = self->depth--;
+
+	if (self->capture && depth == self->capture_depth){
+		bool feed_title = self->capture == &self->feed_title;
+		self->capture = nullptr;
+		if (feed_title){
+			self->title_found = true;
+			self->emit_title();
+		}
+		return;
+	}
+
+	if (self->in_entry && depth == self->entry_depth + 1){
+		self->in_entry = false;
+		self->emit_message();
+	}
+
+	if (self->channel_open && depth == self->channel_depth)
+		self->channel_open = false;
+
+	// everything of interest was read, content behind (other channels, garbage) is not parsed
+	if (self->entry_depth && depth == self->entry_depth){
+		self->done = true;
+		xmlStopParser(self->context);
+	}
+}
+
+
+void StreamParser::on_text(void *ctx, const xmlChar *text, int len){
+	StreamParser *self = static_cast<StreamParser *>(static_cast<xmlParserCtxtPtr>(ctx)->_private);
+	if (self->capture)
+		self->capture->append((const char *) text, len);
+}
+
+
+void StreamParser::feed(std::string_view data){
+	if (this->failed || this->done)
+		return;
+
+	if (this->json){
+		this->json_data.append(data);
+		return;
+	}
+
+	// unwanted characters in front of xml document are skipped, see Parser::strip_feed()
+	if (!this->started){
+		std::string_view text = skip_space(data);
+		if (!text.empty() && text[0] == '{'){
+			this->started = this->json = true;
+			this->json_data.append(text);
+			return;
+		}
+		size_t begin = data.find('<');
+		if (begin == std::string_view::npos)
+			return;
+		data.remove_prefix(begin);
+		this->started = true;
+	}
+
+	// parser stopped after reading everything of interest reports error too
+	if (xmlParseChunk(this->context, data.data(), static_cast<int>(data.size()), 0) && !this->done)
+		this->failed = true;
+}
+
+
+void StreamParser::finish(bool complete){
+	if (this->json){
+		// part of JSON document can't be read at all
+		if (complete && emit_json() && this->poll)
+			this->poll->update(this->url, this->sample, time(nullptr));
+		return;
+	}
+	if (!complete)
+		this->failed = true;
+	if (this->context && !this->failed && !this->done && xmlParseChunk(this->context, nullptr, 0, 1) && !this->done)
+		this->failed = true;
+
+	if (!this->started)
+		return;
+	if (!this->format){
+		std::cerr << "Unknown feed format." << std::endl;
+		return;
+	}
+	emit_title();
+
+	// feed which could not be read stays due, it is fetched again next time
+	if (!this->failed && this->poll)
+		this->poll->update(this->url, this->sample, time(nullptr));
+}
@@ -0,0 +1,75 @@
+/*
+ * tags.cpp
+ *
+ * Recognition of element names used by feed parsers.
+ *
+ * Project: Reader of news feed in format Atom & RSS with support of TLS
+ * Author: Matus Remen (xremen01@stud.fit.vutbr.cz)
+ * Date: 17.10.2026
+ */
+
+#include "../include/tags.hpp"
+
+
+// longest known name, longer names are not looked at further
+#define TAG_MAX_LENGTH 9
+
+// key of perfect hash: name length, lower case first and last letter
+#define TAG_KEY(length, first, last) ((length) << 16 | (first) << 8 | (last))
+
+
+static const char *TAG_NAMES[TAG_COUNT] = {
+	"", "feed", "rss", "channel", "title", "entry", "item", "updated", "pubDate", "author", "link", "id", "guid",
+	"RDF", "published", "date", "creator",
+};
+
+
+TagCache::TagCache(){
+	for (int i = 0; i < TAG_CACHE; i++){
+		this->names[i] = nullptr;
+		this->tags[i] = TAG_OTHER;
+	}
+}
+
+
+const char *tag_name(enum tag id){
+	return TAG_NAMES[id];
+}
+
+
+// confirm the only candidate with given key
+static enum tag confirm(const xmlChar *name, enum tag id){
+	return xmlStrcasecmp(name, (const xmlChar *) TAG_NAMES[id]) ? TAG_OTHER : id;
+}
+
+
+enum tag tag_id(const xmlChar *name){
+	if (!name)
+		return TAG_OTHER;
+
+	int length = 0;
+	while (name[length] && length <= TAG_MAX_LENGTH)
+		length++;
+	if (!length || length > TAG_MAX_LENGTH)
+		return TAG_OTHER;
+
+	switch (TAG_KEY(length, name[0] | 0x20, name[length - 1] | 0x20)){
+		case TAG_KEY(2, 'i', 'd'): return confirm(name, TAG_ID);
+		case TAG_KEY(3, 'r', 's'): return confirm(name, TAG_RSS);
+		case TAG_KEY(3, 'r', 'f'): return confirm(name, TAG_RDF);
+		case TAG_KEY(4, 'f', 'd'): return confirm(name, TAG_FEED);
+		case TAG_KEY(4, 'i', 'm'): return confirm(name, TAG_ITEM);
+		case TAG_KEY(4, 'l', 'k'): return confirm(name, TAG_LINK);
+		case TAG_KEY(4, 'g', 'd'): return confirm(name, TAG_GUID);
+		case TAG_KEY(4, 'd', 'e'): return confirm(name, TAG_DATE);
+		case TAG_KEY(5, 't', 'e'): return confirm(name, TAG_TITLE);
+		case TAG_KEY(5, 'e', 'y'): return confirm(name, TAG_ENTRY);
+		case TAG_KEY(6, 'a', 'r'): return confirm(name, TAG_AUTHOR);
+		case TAG_KEY(7, 'c', 'l'): return confirm(name, TAG_CHANNEL);
+		case TAG_KEY(7, 'c', 'r'): return confirm(name, TAG_CREATOR);
+		case TAG_KEY(7, 'u', 'd'): return confirm(name, TAG_UPDATED);
+		case TAG_KEY(7, 'p', 'e'): return confirm(name, TAG_PUBDATE);
+		case TAG_KEY(9, 'p', 'd'): return confirm(name, TAG_PUBLISHED);
+		default: return TAG_OTHER;
+	}
+}
@@ -0,0 +1,172 @@
+/*
+ * url.cpp
+ *
+ * Single pass scanner of absolute urls, parts are returned as views of the input.
+ *
+ * Project: Reader of news feed in format Atom & RSS with support of TLS
+ * Author: Matus Remen (xremen01@stud.fit.vutbr.cz)
+ * Date: 17.10.2026
+ */
+
+#include "../include/url.hpp"
+
+
+// character classes of url bytes
+#define _URL_ALPHA  0x01  // scheme start
+#define _URL_SCHEME 0x02  // rest of scheme
+#define _URL_DIGIT  0x04  // port
+#define _URL_IPV6   0x08  // inside of IPv6 literal
+#define _URL_HOST   0x10  // registered name or IPv4 address
+#define _URL_TEXT   0x20  // userinfo, path, query and fragment
+
+
+// table of character classes, built once at compile time
+struct url_classes {
+	unsigned char of[256];
+
+	constexpr url_classes() : of(){
+		for (int c = 0x21; c < 0x7f; c++)
+			of[c] = _URL_TEXT | _URL_HOST;
+		for (int c = 0x80; c < 0x100; c++)
+			of[c] = _URL_TEXT | _URL_HOST;
+		// delimiters of authority can't be part of host
+		of[(unsigned char)'/'] &= ~_URL_HOST;
+		of[(unsigned char)'?'] &= ~_URL_HOST;
+		of[(unsigned char)'#'] &= ~_URL_HOST;
+		of[(unsigned char)'@'] &= ~_URL_HOST;
+		of[(unsigned char)':'] &= ~_URL_HOST;
+		of[(unsigned char)'['] &= ~_URL_HOST;
+		of[(unsigned char)']'] &= ~_URL_HOST;
+
+		for (int c = 'a'; c <= 'z'; c++)
+			of[c] |= _URL_ALPHA | _URL_SCHEME;
+		for (int c = 'A'; c <= 'Z'; c++)
+			of[c] |= _URL_ALPHA | _URL_SCHEME;
+		for (int c = '0'; c <= '9'; c++)
+			of[c] |= _URL_SCHEME | _URL_DIGIT | _URL_IPV6;
+		for (int c = 'a'; c <= 'f'; c++)
+			of[c] |= _URL_IPV6;
+		for (int c = 'A'; c <= 'F'; c++)
+			of[c] |= _URL_IPV6;
+		of[(unsigned char)'+'] |= _URL_SCHEME;
+		of[(unsigned char)'-'] |= _URL_SCHEME;
+		of[(unsigned char)'.'] |= _URL_SCHEME | _URL_IPV6;
+		of[(unsigned char)':'] |= _URL_IPV6;
+	}
+};
+
+static constexpr url_classes URL_CLASSES;
+
+static inline bool is(char c, unsigned char cls){
+	return URL_CLASSES.of[(unsigned char)c] & cls;
+}
+
+
+bool scan_url(std::string_view url, struct url_view &parts){
+	const char *s = url.data();
+	size_t len = url.size();
+	size_t i = 0;
+	parts = url_view();
+
+	// scheme ":" "//"
+	if (!len || !is(s[0], _URL_ALPHA))
+		return false;
+	while (i < len && is(s[i], _URL_SCHEME))
+		i++;
+	if (len - i < 3 || s[i] != ':' || s[i + 1] != '/' || s[i + 2] != '/')
+		return false;
+	parts.scheme = url.substr(0, i);
+	i += 3;
+
+	// authority, host starts again after '@' of userinfo, so every byte is read once
+	size_t host = i;
+	size_t colon = 0;   // position of port delimiter, 0 if there is none
+	bool bracket = false;
+	for (; i < len; i++){
+		char c = s[i];
+		if (c == '/' || c == '?' || c == '#')
+			break;
+		if (c == '@'){
+			if (bracket)
+				return false;
+			host = i + 1;
+			colon = 0;
+		}
+		else if (c == '[' && i == host)
+			bracket = true;
+		else if (bracket){
+			if (c == ']')
+				bracket = false;
+			else if (!is(c, _URL_IPV6))
+				return false;
+		}
+		else if (c == ':' && !colon)
+			colon = i;
+		else if (!is(c, _URL_TEXT))
+			return false;
+	}
+	if (bracket)
+		return false;
+
+	if (host > parts.scheme.size() + 3)
+		parts.userinfo = url.substr(parts.scheme.size() + 3, host - 1 - parts.scheme.size() - 3);
+	size_t host_end = colon ? colon : i;
+	parts.host = url.substr(host, host_end - host);
+	if (colon)
+		parts.port = url.substr(colon + 1, i - colon - 1);
+
+	// host is either IPv6 literal or registered name / IPv4 address
+	if (parts.host.empty())
+		return false;
+	if (parts.host[0] == '['){
+		if (parts.host.size() < 3 || parts.host.back() != ']')
+			return false;
+	}
+	else {
+		for (char c : parts.host)
+			if (!is(c, _URL_HOST))
+				return false;
+	}
+	// port has at most 5 digits and fits into 16 bits
+	unsigned long port = 0;
+	if (parts.port.size() > 5)
+		return false;
+	for (char c : parts.port){
+		if (!is(c, _URL_DIGIT))
+			return false;
+		port = port * 10 + (c - '0');
+	}
+	if (port > 65535)
+		return false;
+
+	// path, query and fragment
+	size_t start = i;
+	while (i < len && s[i] != '?' && s[i] != '#'){
+		if (!is(s[i], _URL_TEXT))
+			return false;
+		i++;
+	}
+	parts.path = url.substr(start, i - start);
+
+	if (i < len && s[i] == '?'){
+		start = ++i;
+		while (i < len && s[i] != '#'){
+			if (!is(s[i], _URL_TEXT))
+				return false;
+			i++;
+		}
+		parts.query = url.substr(start, i - start);
+		parts.has_query = true;
+	}
+
+	if (i < len && s[i] == '#'){
+		start = ++i;
+		for (; i < len; i++)
+			if (!is(s[i], _URL_TEXT))
+				return false;
+		parts.fragment = url.substr(start);
+		parts.has_fragment = true;
+	}
+
+	return true;
+}
@@ -0,0 +1,95 @@
+/*
+ * writer.cpp
+ *
+ * Buffered writer of program output.
+ *
+ * Project: Reader of news feed in format Atom & RSS with support of TLS
+ * Author: Matus Remen (xremen01@stud.fit.vutbr.cz)
+ * Date: 17.10.2026
+ */
+
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#include "../include/writer.hpp"
+
+
+Writer::Writer(int fd, size_t capacity){
+	this->fd = fd;
+	this->capacity = capacity ? capacity : 1;
+	this->buffer = new char[this->capacity];
+	this->failed = false;
+	this->calls = 0;
+	setp(this->buffer, this->buffer + this->capacity);
+}
+
+
+Writer::~Writer(){
+	flush();
+	delete[] this->buffer;
+}
+
+
+bool Writer::write_all(const char *data, size_t size){
+	while (size && !this->failed){
+		ssize_t written = write(this->fd, data, size);
+		this->calls++;
+		if (written < 0 && errno == EINTR)
+			continue;
+		if (written <= 0){
+			this->failed = true;
+			break;
+		}
+		data += written;
+		size -= written;
+	}
+	return !this->failed;
+}
+
+
+bool Writer::flush(){
+	size_t size = pptr() - pbase();
+	setp(this->buffer, this->buffer + this->capacity);
+	return write_all(this->buffer, size);
+}
+
+
+uint64_t Writer::writes(){
+	return this->calls;
+}
+
+
+Writer::int_type Writer::overflow(int_type c){
+	if (!flush())
+		return traits_type::eof();
+	if (traits_type::eq_int_type(c, traits_type::eof()))
+		return traits_type::not_eof(c);
+
+	*pptr() = traits_type::to_char_type(c);
+	pbump(1);
+	return c;
+}
+
+
+std::streamsize Writer::xsputn(const char *data, std::streamsize size){
+	size_t space = epptr() - pptr();
+	if (static_cast<size_t>(size) <= space){
+		memcpy(pptr(), data, size);
+		pbump(static_cast<int>(size));
+		return size;
+	}
+
+	// block which does not fit is written right after buffered data, it is not copied
+	if (!flush())
+		return 0;
+	if (static_cast<size_t>(size) >= this->capacity)
+		return write_all(data, size) ? size : 0;
+	memcpy(pptr(), data, size);
+	pbump(static_cast<int>(size));
+	return size;
+}
+
+
+int Writer::sync(){
+	return flush() ? 0 : -1;
+}
@@ -2,7 +2,43 @@
 #include <iostream>
 #include <vector>
 #include <string>
+#include <cstring>
+#include <sstream>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <poll.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
 #include "../include/arguments.hpp"
+#include "../include/buffer.hpp"
+#include "../include/cache.hpp"
+#include "../include/client.hpp"
+#include "../include/decoder.hpp"
+#include "../include/http.hpp"
+#include "../include/url.hpp"
+#include "../include/connect.hpp"
+#include "../include/resolver.hpp"
+#include "../include/seen.hpp"
+#include "../include/sink.hpp"
+#include "../include/output.hpp"
+#include "../include/pipeline.hpp"
+#include "../include/feedlist.hpp"
+#include "../include/scheduler.hpp"
+#include "../include/poll.hpp"
+#include "../include/daemon.hpp"
+#include "../include/formats.hpp"
+#include "../include/parser.hpp"
+#include "../include/stream.hpp"
+#include "../include/sessions.hpp"
+#include "../include/tags.hpp"
+
+using namespace std::string_literals;
 
 void arg_test1(){
 	int argc = 2;
@@ -26,15 +62,1123 @@ void arg_test2(){
 	}
 }
 
+void arg_test3(){
+	// empty fields of time limits keep defaults, too many fields are invalid
+	int argc = 4;
+	char prog[] = "feedreader", url[] = "https://www.test.com/feed", opt[] = "-t";
+	char limits[] = ",2,,0.5", limits_bad[] = "1,2,3,4,5";
+	char *argv[] = {prog, url, opt, limits};
+	char *argv_bad[] = {prog, url, opt, limits_bad};
+	optind = 1;
+	Arguments args = Arguments(argc, argv);
+	optind = 1;
+	Arguments args_bad = Arguments(argc, argv_bad);
+	struct timeouts t = args.get_timeouts();
+	if (args.ok() && !args_bad.ok() && t.connect == TIMEOUT_CONNECT && t.handshake == 2000
+		&& t.first_byte == TIMEOUT_FIRST_BYTE && t.total == 500){
+		std::cout << "Test 12 OK" << std::endl;
+	} else {
+		std::cout << "Test 12 FAIL" << std::endl;
+	}
+}
+
 void test_arguments(){
 	arg_test1();
 	arg_test2();
+	arg_test3();
+}
+
+void buf_test1(){
+	// data written in pieces, including NUL bytes, must come out unchanged
+	Buffer data;
+	std::string expected;
+	for (int i = 0; i < 1000; i++){
+		std::string piece = std::to_string(i) + std::string(1, '\0');
+		memcpy(data.space(piece.size()), piece.c_str(), piece.size());
+		data.commit(piece.size());
+		expected += piece;
+	}
+	if (data.view() == expected && data.view(3, 2) == expected.substr(3, 2)){
+		std::cout << "Test 03 OK" << std::endl;
+	} else {
+		std::cout << "Test 03 FAIL" << std::endl;
+	}
+}
+
+void buf_test2(){
+	// reserved buffer must not move while filled up to reserved size
+	Buffer data;
+	data.reserve(4096);
+	const char *start = data.space(0);
+	for (int i = 0; i < 4096; i++){
+		*data.space(1) = 'x';
+		data.commit(1);
+	}
+	if (data.data() == start && data.size() == 4096){
+		std::cout << "Test 04 OK" << std::endl;
+	} else {
+		std::cout << "Test 04 FAIL" << std::endl;
+	}
+}
+
+void test_buffer(){
+	buf_test1();
+	buf_test2();
+}
+
+// feed response to parser byte by byte, returns parser result and decoded body
+int http_feed(std::string raw, bool close, struct response &resp, std::string &body){
+	Buffer data;
+	HttpParser parser;
+	int status = HTTP_MORE;
+	for (char c : raw){
+		*data.space(1) = c;
+		data.commit(1);
+		if ((status = parser.parse(data, resp)) != HTTP_MORE)
+			break;
+	}
+	if (status == HTTP_MORE && close)
+		status = parser.eof(data, resp);
+	body = std::string(resp.body);
+	return status;
+}
+
+void http_test1(){
+	// chunked body with extensions and trailer, preceded by interim response
+	struct response resp;
+	std::string body;
+	int status = http_feed(
+		"HTTP/1.1 100 Continue\r\n\r\n"
+		"HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\nX-A: 1\r\nx-a: 2\r\n\r\n"
+		"5;ext=1\r\n<feed\r\n"
+		"1A\r\n><title>abcdefgh</title>\0x\r\n"
+		"8\r\n</feed>\n\r\n"
+		"0\r\nExpires: never\r\n\r\n"s, false, resp, body);
+	if (status == HTTP_DONE && resp.status_code == "200" && resp.keep_alive
+		&& body == std::string("<feed><title>abcdefgh</title>\0x</feed>\n", 39)
+		&& resp.headers["x-a"] == "1, 2" && resp.trailers["expires"] == "never"){
+		std::cout << "Test 05 OK" << std::endl;
+	} else {
+		std::cout << "Test 05 FAIL" << std::endl;
+	}
+}
+
+void http_test2(){
+	// body of known length and body delimited by end of connection
+	struct response resp, resp_eof;
+	std::string body, body_eof;
+	int status = http_feed("HTTP/1.1 200 OK\r\nContent-Length: 4\r\nConnection: close\r\n\r\nabcdEXTRA", false, resp, body);
+	int status_eof = http_feed("HTTP/1.0 200 OK\r\n\r\n<rss/>", true, resp_eof, body_eof);
+	if (status == HTTP_DONE && body == "abcd" && !resp.keep_alive && status_eof == HTTP_DONE && body_eof == "<rss/>"){
+		std::cout << "Test 06 OK" << std::endl;
+	} else {
+		std::cout << "Test 06 FAIL" << std::endl;
+	}
+}
+
+void http_test3(){
+	// truncated and malformed responses
+	struct response resp;
+	std::string body;
+	int truncated = http_feed("HTTP/1.1 200 OK\r\nContent-Length: 10\r\n\r\nabc", true, resp, body);
+	int malformed = http_feed("HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\nzz\r\n", false, resp, body);
+	int trailing = http_feed("HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n5zz\r\nabcde\r\n0\r\n\r\n", false, resp, body);
+	int overflow = http_feed("HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n10000000000000000\r\nabc", false, resp, body);
+	if (truncated == HTTP_ERROR && malformed == HTTP_ERROR && trailing == HTTP_ERROR && overflow == HTTP_ERROR){
+		std::cout << "Test 07 OK" << std::endl;
+	} else {
+		std::cout << "Test 07 FAIL" << std::endl;
+	}
+}
+
+void test_http(){
+	http_test1();
+	http_test2();
+	http_test3();
+}
+
+// compress data with zlib, window bits select wrapper: 15 zlib, 31 gzip, -15 raw deflate
+std::string dec_compress(std::string data, int bits){
+	z_stream zs;
+	memset(&zs, 0, sizeof(zs));
+	deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, bits, 8, Z_DEFAULT_STRATEGY);
+	std::string out(deflateBound(&zs, data.size()) + 32, '\0');
+	zs.next_in = (Bytef *) data.data();
+	zs.avail_in = static_cast<uInt>(data.size());
+	zs.next_out = (Bytef *) out.data();
+	zs.avail_out = static_cast<uInt>(out.size());
+	deflate(&zs, Z_FINISH);
+	out.resize(zs.total_out);
+	deflateEnd(&zs);
+	return out;
+}
+
+// decode body given in pieces of size step, returns false on error or incomplete stream
+bool dec_feed(std::string encoding, std::string body, size_t step, std::string &decoded){
+	Decoder decoder;
+	Buffer out;
+	if (!decoder.init(encoding))
+		return false;
+	for (size_t pos = 0; pos < body.size(); pos += step)
+		if (!decoder.decode(std::string_view(body).substr(pos, step), out))
+			return false;
+	decoded = std::string(out.view());
+	return decoder.done();
+}
+
+void dec_test1(){
+	// gzip, deflate with zlib wrapper and raw deflate, whole and byte by byte
+	std::string text;
+	for (int i = 0; i < 2000; i++)
+		text += "<entry><title>" + std::to_string(i) + "</title></entry>";
+	bool ok = true;
+	std::string decoded;
+	for (size_t step : {(size_t) 1, text.size()}){
+		ok = ok && dec_feed("gzip", dec_compress(text, 31), step, decoded) && decoded == text;
+		ok = ok && dec_feed("deflate", dec_compress(text, 15), step, decoded) && decoded == text;
+		ok = ok && dec_feed("Deflate", dec_compress(text, -15), step, decoded) && decoded == text;
+	}
+	if (ok){
+		std::cout << "Test 29 OK" << std::endl;
+	} else {
+		std::cout << "Test 29 FAIL" << std::endl;
+	}
+}
+
+void dec_test2(){
+	// concatenated gzip members, truncated stream, body without data and unknown coding
+	std::string members = dec_compress("<feed>", 31) + dec_compress("</feed>", 31);
+	std::string truncated = dec_compress("<feed></feed>", 31);
+	truncated.resize(truncated.size() - 4);
+	std::string concatenated, partial, empty, unknown;
+	if (dec_feed("gzip", members, 3, concatenated) && concatenated == "<feed></feed>"
+		&& !dec_feed("gzip", truncated, 1, partial) && dec_feed("gzip", "", 1, empty) && empty.empty()
+		&& !dec_feed("compress", "x", 1, unknown) && !dec_feed("gzip, br", "x", 1, unknown)){
+		std::cout << "Test 30 OK" << std::endl;
+	} else {
+		std::cout << "Test 30 FAIL" << std::endl;
+	}
+}
+
+void dec_test3(){
+	// body decompressing over limit is refused, small compressed piece must not exhaust memory
+	std::string bomb = dec_compress(std::string(DECODE_LIMIT + 1, '\0'), 31);
+	std::string decoded;
+	if (bomb.size() < 1024 * 1024 && !dec_feed("gzip", bomb, bomb.size(), decoded)){
+		std::cout << "Test 39 OK" << std::endl;
+	} else {
+		std::cout << "Test 39 FAIL" << std::endl;
+	}
+}
+
+void test_decoder(){
+	dec_test1();
+	dec_test2();
+	dec_test3();
+}
+
+void url_test1(){
+	// all parts of url, IPv6 literal with userinfo and default port
+	struct url_view full, ipv6;
+	bool ok_full = scan_url("https://news.example.com:8443/a/feed.xml?x=1&y=2#top", full);
+	bool ok_ipv6 = scan_url("http://user:pw@[2001:db8::1]?q", ipv6);
+	if (ok_full && full.scheme == "https" && full.host == "news.example.com" && full.port == "8443"
+		&& full.path == "/a/feed.xml" && full.query == "x=1&y=2" && full.fragment == "top"
+		&& ok_ipv6 && ipv6.userinfo == "user:pw" && ipv6.host == "[2001:db8::1]" && ipv6.port.empty()
+		&& ipv6.path.empty() && ipv6.has_query && ipv6.query == "q" && !ipv6.has_fragment){
+		std::cout << "Test 08 OK" << std::endl;
+	} else {
+		std::cout << "Test 08 FAIL" << std::endl;
+	}
+}
+
+void url_test2(){
+	// invalid urls
+	const char *invalid[] = {"", "news.example.com/feed", "https:/x", "https://", "https://:80/",
+		"http://host:65536/", "http://host:8x/", "http://[::1/", "http://[::g]/", "http://a b/",
+		"http://host/feed\r\n", "1http://host/"};
+	struct url_view parts;
+	bool ok = true;
+	for (const char *url : invalid)
+		ok = ok && !scan_url(url, parts);
+	if (ok){
+		std::cout << "Test 09 OK" << std::endl;
+	} else {
+		std::cout << "Test 09 FAIL" << std::endl;
+	}
+}
+
+void test_url(){
+	url_test1();
+	url_test2();
+}
+
+struct address make_address(int family, const char *ip){
+	struct address addr;
+	memset(&addr, 0, sizeof(addr));
+	if (family == AF_INET){
+		struct sockaddr_in *in = (struct sockaddr_in *)&addr.addr;
+		in->sin_family = AF_INET;
+		inet_pton(AF_INET, ip, &in->sin_addr);
+		addr.length = sizeof(*in);
+	}
+	else {
+		struct sockaddr_in6 *in6 = (struct sockaddr_in6 *)&addr.addr;
+		in6->sin6_family = AF_INET6;
+		inet_pton(AF_INET6, ip, &in6->sin6_addr);
+		addr.length = sizeof(*in6);
+	}
+	return addr;
+}
+
+void resolver_test1(){
+	// every name is looked up once, failures included, prefetched names are shared
+	int lookups = 0;
+	Resolver resolver = Resolver([&](const std::string &host, std::vector<struct address> &addresses){
+		lookups++;
+		if (host != "feeds.test")
+			return false;
+		addresses.push_back(make_address(AF_INET6, "2001:db8::1"));
+		addresses.push_back(make_address(AF_INET, "192.0.2.1"));
+		return true;
+	});
+	std::vector<struct address> first, second, missing;
+	resolver.prefetch("feeds.test");
+	bool ok = resolver.resolve("feeds.test", first) && resolver.resolve("feeds.test", second);
+	ok = ok && !resolver.resolve("missing.test", missing) && !resolver.resolve("missing.test", missing);
+	if (ok && lookups == 2 && first.size() == 2 && second.size() == 2 && first[1].addr.ss_family == AF_INET){
+		std::cout << "Test 10 OK" << std::endl;
+	} else {
+		std::cout << "Test 10 FAIL" << std::endl;
+	}
+}
+
+void resolver_test2(){
+	// address families alternate, unreachable addresses are skipped for the listening one
+	int server = socket(AF_INET, SOCK_STREAM, 0);
+	struct sockaddr_in addr;
+	socklen_t length = sizeof(addr);
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	bind(server, (struct sockaddr *)&addr, sizeof(addr));
+	listen(server, 4);
+	getsockname(server, (struct sockaddr *)&addr, &length);
+	unsigned short port = ntohs(addr.sin_port);
+
+	std::vector<struct address> addresses = {make_address(AF_INET6, "::1"), make_address(AF_INET6, "::1"),
+		make_address(AF_INET, "127.0.0.1")};
+	std::vector<struct address> ordered = interleave_addresses(addresses);
+	int fd = happy_connect(addresses, port, 2000);
+	struct sockaddr_in peer;
+	length = sizeof(peer);
+	bool connected = fd >= 0 && getpeername(fd, (struct sockaddr *)&peer, &length) == 0 && peer.sin_family == AF_INET;
+	if (fd >= 0)
+		close(fd);
+	close(server);
+
+	// nobody listens anymore
+	int refused = happy_connect(addresses, port, 2000);
+	if (ordered[1].addr.ss_family == AF_INET && connected && refused < 0){
+		std::cout << "Test 11 OK" << std::endl;
+	} else {
+		std::cout << "Test 11 FAIL" << std::endl;
+	}
+}
+
+void resolver_test3(){
+	// caller stops waiting for slow lookup after timeout, result is kept for later requests
+	Resolver resolver = Resolver([](const std::string &, std::vector<struct address> &addresses){
+		std::this_thread::sleep_for(std::chrono::milliseconds(300));
+		addresses.push_back(make_address(AF_INET, "192.0.2.1"));
+		return true;
+	});
+	std::vector<struct address> early, late;
+	auto start = std::chrono::steady_clock::now();
+	bool timed_out = !resolver.resolve("slow.test", early, 50);
+	auto waited = std::chrono::steady_clock::now() - start;
+	bool resolved = resolver.resolve("slow.test", late);
+	if (timed_out && waited < std::chrono::milliseconds(250) && resolved && late.size() == 1){
+		std::cout << "Test 31 OK" << std::endl;
+	} else {
+		std::cout << "Test 31 FAIL" << std::endl;
+	}
+}
+
+void test_resolver(){
+	resolver_test1();
+	resolver_test2();
+	resolver_test3();
+}
+
+
+void seen_test1(){
+	// entries survive reopening of store and growth of table
+	char path[] = "/tmp/feedreader-seen-XXXXXX";
+	close(mkstemp(path));
+	unlink(path);
+	bool ok = true;
+	{
+		SeenStore seen;
+		ok = seen.open(path) && seen.add("http://a/feed", "id-1") && !seen.add("http://a/feed", "id-1")
+			&& seen.add("http://b/feed", "id-1");
+		for (int i = 0; i < 60000; i++)
+			ok = ok && seen.add("http://c/feed", std::to_string(i));
+	}
+	SeenStore seen;
+	ok = ok && seen.open(path) && seen.count() == 60002 && !seen.add("http://a/feed", "id-1")
+		&& !seen.add("http://c/feed", "59999") && seen.add("http://c/feed", "60000");
+	unlink(path);
+	if (ok){
+		std::cout << "Test 13 OK" << std::endl;
+	} else {
+		std::cout << "Test 13 FAIL" << std::endl;
+	}
+}
+
+void seen_test2(){
+	// file which is not a store is refused
+	char path[] = "/tmp/feedreader-seen-XXXXXX";
+	int fd = mkstemp(path);
+	bool written = write(fd, "not a store of seen entries", 27) == 27;
+	close(fd);
+	SeenStore seen;
+	bool opened = seen.open(path);
+	unlink(path);
+	if (written && !opened){
+		std::cout << "Test 14 OK" << std::endl;
+	} else {
+		std::cout << "Test 14 FAIL" << std::endl;
+	}
+}
+
+void test_seen(){
+	seen_test1();
+	seen_test2();
+}
+
+// remove directory with files created by test
+void remove_dir(std::string path){
+	DIR *dir = opendir(path.c_str());
+	if (!dir)
+		return;
+	while (struct dirent *e = readdir(dir))
+		if (strcmp(e->d_name, ".") && strcmp(e->d_name, ".."))
+			unlink((path + "/" + e->d_name).c_str());
+	closedir(dir);
+	rmdir(path.c_str());
+}
+
+// listening socket on loopback with port chosen by system
+int listen_loopback(unsigned short &port){
+	int server = socket(AF_INET, SOCK_STREAM, 0);
+	struct sockaddr_in addr;
+	socklen_t length = sizeof(addr);
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	bind(server, (struct sockaddr *)&addr, sizeof(addr));
+	listen(server, 16);
+	getsockname(server, (struct sockaddr *)&addr, &length);
+	port = ntohs(addr.sin_port);
+	return server;
+}
+
+// answer one connection per response on listening socket, requests are collected
+void serve_responses(int server, std::vector<std::string> responses, std::vector<std::string> *requests){
+	for (std::string &response : responses){
+		int fd = accept(server, nullptr, nullptr);
+		if (fd < 0)
+			return;
+		std::string request;
+		char buffer[1024];
+		ssize_t length;
+		while (request.find("\r\n\r\n") == std::string::npos && (length = read(fd, buffer, sizeof(buffer))) > 0)
+			request.append(buffer, length);
+		requests->push_back(request);
+		write(fd, response.data(), response.size());
+		close(fd);
+	}
+}
+
+// answer requests of one keep-alive connection with their path, connection is closed
+// by server after limit responses (0 is unlimited) or when client closes it
+void serve_path_connection(int fd, size_t limit){
+	std::string request;
+	char buffer[1024];
+	for (size_t served = 0; !limit || served < limit; served++){
+		size_t end;
+		ssize_t length = 1;
+		while ((end = request.find("\r\n\r\n")) == std::string::npos && (length = read(fd, buffer, sizeof(buffer))) > 0)
+			request.append(buffer, length);
+		if (length <= 0)
+			break;
+		std::string path = request.substr(4, request.find(' ', 4) - 4);
+		request.erase(0, end + 4);
+		std::string response = "HTTP/1.1 200 OK\r\nContent-Length: " + std::to_string(path.size()) + "\r\n\r\n" + path;
+		write(fd, response.data(), response.size());
+	}
+	close(fd);
+}
+
+// accept connections served by serve_path_connection until stop is set, connections are counted
+void serve_paths(int server, size_t limit, std::atomic<bool> *stop, std::atomic<int> *connections){
+	std::vector<std::thread> threads;
+	struct pollfd waiting = {server, POLLIN, 0};
+	while (!*stop){
+		if (poll(&waiting, 1, 20) <= 0)
+			continue;
+		int fd = accept(server, nullptr, nullptr);
+		if (fd < 0)
+			continue;
+		(*connections)++;
+		threads.emplace_back(serve_path_connection, fd, limit);
+	}
+	for (std::thread &thread : threads)
+		thread.join();
+}
+
+void keepalive_test1(){
+	// requests share one connection, connection closed by server in the meantime is replaced
+	unsigned short port;
+	int server = listen_loopback(port);
+	std::string base = "http://127.0.0.1:" + std::to_string(port);
+	std::atomic<bool> stop{false};
+	std::atomic<int> accepted{0};
+	std::thread thread(serve_paths, server, 2, &stop, &accepted);
+
+	std::vector<std::string> bodies;
+	struct client_stats stats;
+	{
+		Client client = Client("", "");
+		for (std::string path : {"/a", "/b", "/c"}){
+			Buffer data;
+			bodies.push_back(std::string(client.request(base + path, data)));
+			// server closes connection after second response, it must be noticed by client
+			if (path == "/b")
+				std::this_thread::sleep_for(std::chrono::milliseconds(50));
+		}
+		stats = client.get_stats();
+	}
+	stop = true;
+	thread.join();
+	close(server);
+
+	if (bodies == std::vector<std::string>{"/a", "/b", "/c"} && stats.requests == 3 && stats.connections == 2
+		&& accepted == 2){
+		std::cout << "Test 36 OK" << std::endl;
+	} else {
+		std::cout << "Test 36 FAIL" << std::endl;
+	}
+}
+
+void cache_test1(){
+	// validators and body survive in cache, incomplete entry does not replace complete one
+	char dir[] = "/tmp/feedreader-cache-XXXXXX";
+	mkdtemp(dir);
+	HttpCache cache = HttpCache(std::string(dir) + "/feeds");
+	bool ok = cache.init();
+
+	std::string tmp;
+	struct validators stored = {"\"v1\"", "Sat, 17 Oct 2026 10:00:00 GMT"};
+	FILE *entry = cache.begin("http://a/feed", stored, tmp);
+	ok = ok && entry && fputs("<rss>first</rss>", entry) >= 0;
+	cache.end("http://a/feed", entry, tmp, true);
+	struct validators newer = {"\"v2\"", ""};
+	entry = cache.begin("http://a/feed", newer, tmp);
+	ok = ok && entry && fputs("<rss>cut", entry) >= 0;
+	cache.end("http://a/feed", entry, tmp, false);
+
+	struct validators v, none;
+	Buffer data, piece;
+	std::string streamed;
+	ok = ok && cache.lookup("http://a/feed", v) && v.etag == stored.etag && v.last_modified == stored.last_modified
+		&& cache.read("http://a/feed", data) && data.view() == "<rss>first</rss>"
+		&& cache.read("http://a/feed", piece, [&](std::string_view s){ streamed += s; }) && streamed == "<rss>first</rss>"
+		&& cache.changed("http://a/feed") && !cache.lookup("http://b/feed", none) && !cache.changed("http://b/feed");
+	remove_dir(std::string(dir) + "/feeds");
+	rmdir(dir);
+	if (ok){
+		std::cout << "Test 32 OK" << std::endl;
+	} else {
+		std::cout << "Test 32 FAIL" << std::endl;
+	}
+}
+
+void cache_test2(){
+	// second request is conditional, body of 304 response is read from cache
+	char dir[] = "/tmp/feedreader-cache-XXXXXX";
+	mkdtemp(dir);
+	HttpCache cache = HttpCache(dir);
+	unsigned short port;
+	int server = listen_loopback(port);
+	std::string url = "http://127.0.0.1:" + std::to_string(port) + "/feed";
+
+	std::vector<std::string> requests;
+	std::thread thread(serve_responses, server, std::vector<std::string>{
+		"HTTP/1.1 200 OK\r\nETag: \"v1\"\r\nLast-Modified: Sat, 17 Oct 2026 10:00:00 GMT\r\n"
+			"Content-Length: 12\r\nConnection: close\r\n\r\n<rss>1</rss>",
+		"HTTP/1.1 304 Not Modified\r\nETag: \"v1\"\r\nConnection: close\r\n\r\n"}, &requests);
+	Client client = Client("", "");
+	client.set_http_cache(&cache);
+	Buffer first, second;
+	std::string body = std::string(client.request(url, first));
+	std::string cached = std::string(client.request(url, second));
+	thread.join();
+	close(server);
+	remove_dir(dir);
+
+	if (body == "<rss>1</rss>" && cached == body && requests.size() == 2
+		&& requests[0].find("If-None-Match") == std::string::npos
+		&& requests[1].find("If-None-Match: \"v1\"\r\n") != std::string::npos
+		&& requests[1].find("If-Modified-Since: Sat, 17 Oct 2026 10:00:00 GMT\r\n") != std::string::npos){
+		std::cout << "Test 33 OK" << std::endl;
+	} else {
+		std::cout << "Test 33 FAIL" << std::endl;
+	}
+}
+
+void test_cache(){
+	cache_test1();
+	cache_test2();
+}
+
+// resumable TLS 1.2 session with given id, valid for lifetime seconds from start
+SSL_SESSION *make_session(unsigned char id, time_t start, long lifetime){
+	// session can be encoded only with cipher, ECDHE-RSA-AES128-GCM-SHA256 is taken
+	SSL_CTX *ctx = SSL_CTX_new(TLS_client_method());
+	SSL *ssl = SSL_new(ctx);
+	const unsigned char suite[] = {0xC0, 0x2F};
+	SSL_SESSION *session = SSL_SESSION_new();
+	SSL_SESSION_set_cipher(session, SSL_CIPHER_find(ssl, suite));
+	SSL_free(ssl);
+	SSL_CTX_free(ctx);
+
+	unsigned char bytes[32], key[48];
+	memset(bytes, id, sizeof(bytes));
+	memset(key, id, sizeof(key));
+	SSL_SESSION_set_protocol_version(session, TLS1_2_VERSION);
+	SSL_SESSION_set1_id(session, bytes, sizeof(bytes));
+	SSL_SESSION_set1_master_key(session, key, sizeof(key));
+	SSL_SESSION_set_time(session, start);
+	SSL_SESSION_set_timeout(session, lifetime);
+	return session;
+}
+
+void session_test1(){
+	// alive sessions survive saving and loading, expired ones are dropped
+	char path[] = "/tmp/feedreader-sessions-XXXXXX";
+	close(mkstemp(path));
+	chmod(path, 0644);
+	bool ok;
+	{
+		SessionCache cache;
+		cache.put("a.test:443", make_session(1, time(nullptr), 300));
+		cache.put("b.test:443", make_session(2, time(nullptr) - 600, 300));
+		cache.put("c.test:8443", make_session(3, time(nullptr), 300));
+		ok = cache.save(path);
+	}
+	// file is readable only by owner, whatever mode previous one had
+	struct stat info;
+	ok = ok && !stat(path, &info) && (info.st_mode & 0777) == 0600;
+	SessionCache loaded, missing;
+	ok = ok && loaded.load(path) && !missing.load("/nonexistent/sessions");
+	unlink(path);
+
+	SSL_SESSION *a = loaded.get("a.test:443");
+	SSL_SESSION *b = loaded.get("b.test:443");
+	SSL_SESSION *c = loaded.get("c.test:8443");
+	unsigned int length = 0;
+	const unsigned char *id = a ? SSL_SESSION_get_id(a, &length) : nullptr;
+	ok = ok && a && !b && c && length == 32 && id[0] == 1 && !loaded.get("a.test:8443");
+	SSL_SESSION_free(a);
+	SSL_SESSION_free(c);
+	if (ok){
+		std::cout << "Test 35 OK" << std::endl;
+	} else {
+		std::cout << "Test 35 FAIL" << std::endl;
+	}
+}
+
+void sink_test1(){
+	// special characters are escaped in JSON and quoted in CSV
+	struct entry e = {"http://a/feed", "Feed", "Say \"hi\",\nnow\x01", "", "A\\B", "http://a/1"};
+	std::ostringstream json, csv;
+	JsonSink().message(json, e, 0);
+	CsvSink().message(csv, e, 0);
+	if (json.str() == "{\"feed\":\"http://a/feed\",\"feed_title\":\"Feed\",\"title\":\"Say \\\"hi\\\",\\nnow\\u0001\","
+			"\"updated\":\"\",\"author\":\"A\\\\B\",\"link\":\"http://a/1\"}\n"
+		&& csv.str() == "http://a/feed,Feed,\"Say \"\"hi\"\",\nnow\x01\",,A\\B,http://a/1\r\n"){
+		std::cout << "Test 15 OK" << std::endl;
+	} else {
+		std::cout << "Test 15 FAIL" << std::endl;
+	}
+}
+
+void sink_test2(){
+	// binary record is length prefixed, all numbers little endian
+	struct entry e = {"u", "", "t", "", "", "l"};
+	std::ostringstream out;
+	BinarySink sink;
+	sink.header(out);
+	sink.message(out, e, 0);
+	std::string expected = BINARY_MAGIC + "\x1b\0\0\0"s + "\x01\0\0\0u"s + "\0\0\0\0"s + "\x01\0\0\0t"s
+		+ "\0\0\0\0"s + "\0\0\0\0"s + "\x01\0\0\0l"s;
+	if (out.str() == expected){
+		std::cout << "Test 16 OK" << std::endl;
+	} else {
+		std::cout << "Test 16 FAIL" << std::endl;
+	}
+}
+
+void test_sink(){
+	sink_test1();
+	sink_test2();
+}
+
+void output_test1(){
+	// lines are not written one by one, only when policy says so
+	int fd = open("/dev/null", O_WRONLY);
+	{
+	Output feed(fd, FLUSH_FEED);
+	Output size(fd, FLUSH_SIZE, 10);
+	for (int i = 0; i < 7; i++){
+		feed.stream() << "line\n";
+		size.stream() << "line\n";
+	}
+	uint64_t before = feed.writes();
+	feed.feed_done();
+	int policy = 0;
+	size_t threshold = 0;
+	bool parsed = Output::parse_policy("4096", policy, threshold) && policy == FLUSH_SIZE && threshold == 4096
+		&& !Output::parse_policy("sometimes", policy, threshold) && !Output::parse_policy("99999999999", policy, threshold);
+	if (before == 0 && feed.writes() == 1 && size.writes() == 3 && parsed){
+		std::cout << "Test 17 OK" << std::endl;
+	} else {
+		std::cout << "Test 17 FAIL" << std::endl;
+	}
+	}
+	close(fd);
+}
+
+void pipeline_test1(){
+	// feeds parsed by several threads out of order are printed in order of list
+	unsigned short port;
+	int server = listen_loopback(port);
+	std::atomic<bool> stop{false};
+	std::atomic<int> accepted{0};
+	std::thread thread(serve_paths, server, 0, &stop, &accepted);
+
+	std::vector<std::string> list;
+	std::string expected;
+	for (int i = 0; i < 24; i++){
+		list.push_back("http://127.0.0.1:" + std::to_string(port) + "/" + std::to_string(i));
+		expected += "/" + std::to_string(i) + "\n";
+	}
+	std::vector<std::string_view> urls(list.begin(), list.end());
+
+	char path[] = "/tmp/feedreader-pipeline-XXXXXX";
+	int fd = mkstemp(path);
+	{
+		Fetcher fetcher = Fetcher("", "", 4);
+		struct host_limits limits;
+		limits.connections = 0;
+		fetcher.set_host_limits(limits);
+		Output output(fd, FLUSH_EXIT);
+		Pipeline pipeline = Pipeline(fetcher, 3);
+		// earlier feeds take longer to parse
+		pipeline.run(urls, [](size_t idx, std::string_view body, std::ostream &out){
+			std::this_thread::sleep_for(std::chrono::milliseconds((24 - idx) % 6));
+			out << body << "\n";
+		}, output);
+		output.flush();
+	}
+	stop = true;
+	thread.join();
+	close(server);
+
+	std::string printed(expected.size() + 16, '\0');
+	ssize_t length = pread(fd, &printed[0], printed.size(), 0);
+	printed.resize(length > 0 ? length : 0);
+	close(fd);
+	unlink(path);
+	if (printed == expected){
+		std::cout << "Test 37 OK" << std::endl;
+	} else {
+		std::cout << "Test 37 FAIL" << std::endl;
+	}
+}
+
+// peak resident set size in kilobytes
+long peak_rss(){
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+	return usage.ru_maxrss / 1024;
+#else
+	return usage.ru_maxrss;
+#endif
+}
+
+void parser_test1(){
+	// parsing the same feed over and over must not grow memory, every field used to leak
+	std::string feed = "<?xml version=\"1.0\"?><rss version=\"2.0\"><channel><title>Leak</title>";
+	for (int i = 0; i < 200; i++){
+		feed += "<item><title>Entry number " + std::to_string(i) + " with a longer title</title>"
+			"<link>http://example.com/entries/" + std::to_string(i) + "</link>"
+			"<author>someone@example.com (Some One)</author>"
+			"<pubDate>Mon, 17 Oct 2026 10:00:00 GMT</pubDate></item>";
+	}
+	feed += "</channel></rss>";
+
+	std::ostringstream out;
+	for (int i = 0; i < 20; i++){
+		Parser(feed, true, true, true, out).parse_feed();
+		out.str("");
+	}
+	long before = peak_rss();
+	for (int i = 0; i < 500; i++){
+		Parser(feed, true, true, true, out).parse_feed();
+		out.str("");
+	}
+	long growth = peak_rss() - before;
+
+	Parser(feed, true, true, true, out).parse_feed();
+	bool printed = out.str().find("*** Leak ***") == 0 && out.str().find("Entry number 199") != std::string::npos;
+	if (growth < 4096 && printed){
+		std::cout << "Test 18 OK" << std::endl;
+	} else {
+		std::cout << "Test 18 FAIL" << std::endl;
+	}
+}
+
+void parser_test2(){
+	// tags are recognized regardless of case, entries in front of title are printed after it
+	std::string feed = "<feed><ENTRY><Title>First</Title><LINK href=\"http://a/1\"/><updated>2026</updated></ENTRY>"
+		"<TITLE>Atom</TITLE><entry><title>Second</title><titles>x</titles></entry></feed>";
+	std::ostringstream out;
+	Parser(feed, true, false, true, out).parse_feed();
+	bool tags = tag_id((xmlChar *) "pubdate") == TAG_PUBDATE && tag_id((xmlChar *) "guid") == TAG_GUID
+		&& tag_id((xmlChar *) "gui") == TAG_OTHER && tag_id((xmlChar *) "links") == TAG_OTHER
+		&& tag_id((xmlChar *) "description") == TAG_OTHER;
+	if (tags && out.str() == "*** Atom ***\nFirst\nAktualizace: 2026\nURL: http://a/1\nSecond\n"){
+		std::cout << "Test 19 OK" << std::endl;
+	} else {
+		std::cout << "Test 19 FAIL" << std::endl;
+	}
+}
+
+void parser_test3(){
+	// characters around xml document are ignored, document is not copied to be parsed
+	std::string body = "\xef\xbb\xbf  garbage <rss><channel><title>Padded</title></channel></rss>\r\n0\r\n";
+	std::ostringstream out, none;
+	Parser(body, false, false, false, out).parse_feed();
+	Parser(std::string_view(body).substr(0, 16), false, false, false, none).parse_feed();
+	if (out.str() == "*** Padded ***\n" && none.str().empty()){
+		std::cout << "Test 20 OK" << std::endl;
+	} else {
+		std::cout << "Test 20 FAIL" << std::endl;
+	}
+}
+
+void stream_test1(){
+	// feed given byte by byte is printed the same as by DOM parser
+	std::vector<std::string> feeds = {
+		"\n  <?xml version=\"1.0\"?><feed xmlns=\"http://www.w3.org/2005/Atom\"><entry><title>Early &amp; first</title>"
+			"<updated>2026-10-17T10:00:00Z</updated><author><name>A</name></author><link href=\"http://a/1\"/></entry>"
+			"<title>Atom <![CDATA[feed]]></title><entry><title>Second</title><link rel=\"alternate\" href=\"http://a/2\"/></entry></feed>",
+		"<?xml version=\"1.0\"?><rss version=\"2.0\"><channel><title>RSS</title><item><title>One</title>"
+			"<link>http://r/1</link><author>x@r (X)</author><pubDate>Sat, 17 Oct 2026 10:00:00 GMT</pubDate></item>"
+			"<item><title>Two</title></item></channel></rss>",
+		"{\"version\": \"https://jsonfeed.org/version/1.1\", \"title\": \"JSON\", \"items\": "
+			"[{\"id\": \"1\", \"title\": \"Item\", \"url\": \"http://j/1\", \"date_published\": \"2026-10-17T10:00:00Z\"}]}"};
+	bool ok = true;
+	for (std::string &feed : feeds){
+		std::ostringstream whole, pieces;
+		Parser(feed, true, true, true, whole).parse_feed();
+		StreamParser parser = StreamParser(true, true, true, pieces);
+		for (char c : feed)
+			parser.feed(std::string_view(&c, 1));
+		parser.finish();
+		ok = ok && !whole.str().empty() && whole.str() == pieces.str();
+	}
+	if (ok){
+		std::cout << "Test 34 OK" << std::endl;
+	} else {
+		std::cout << "Test 34 FAIL" << std::endl;
+	}
+}
+
+void format_test1(){
+	// format is recognized from prolog and root element only
+	auto id = [](std::string data){
+		const struct format *format = detect_format(data);
+		return format ? format->id : 0;
+	};
+	if (id("\xef\xbb\xbf <?xml version=\"1.0\"?>\n<!-- <rss> --><feed xmlns=\"http://www.w3.org/2005/Atom\">") == _ATOM
+		&& id("junk<?xml version=\"1.0\"?><!DOCTYPE rss [<!ENTITY a \"<b>\">]><RSS version=\"2.0\"") == _RSS2
+		&& id("<rdf:RDF xmlns:rdf=\"http://www.w3.org/1999/02/22-rdf-syntax-ns#\">") == _RDF
+		&& id("\n  {\"version\": \"https://jsonfeed.org/version/1.1\"") == _JSON
+		&& id("<!DOCTYPE html><html><body>") == 0 && id("<?xml version=\"1.0\"?>") == 0 && id("") == 0){
+		std::cout << "Test 21 OK" << std::endl;
+	} else {
+		std::cout << "Test 21 FAIL" << std::endl;
+	}
+}
+
+void format_test2(){
+	// RSS 1.0 items are siblings of channel, Dublin Core fields are read, entities are expanded
+	std::string feed = "<?xml version=\"1.0\"?><!DOCTYPE rdf:RDF [<!ENTITY c \"(c)\">]>"
+		"<rdf:RDF xmlns:rdf=\"http://www.w3.org/1999/02/22-rdf-syntax-ns#\" xmlns=\"http://purl.org/rss/1.0/\" "
+		"xmlns:dc=\"http://purl.org/dc/elements/1.1/\"><channel><title>RDF &c;</title></channel><image><title>Logo</title></image>"
+		"<item><title>One</title><link>http://a/1</link><dc:date>2026</dc:date><dc:creator>Ann</dc:creator></item>"
+		"<item><title>Two</title></item></rdf:RDF>";
+	std::ostringstream out;
+	Parser(feed, true, true, true, out).parse_feed();
+	if (out.str() == "*** RDF (c) ***\nOne\nAktualizace: 2026\nAutor: Ann\nURL: http://a/1\nTwo\n"){
+		std::cout << "Test 22 OK" << std::endl;
+	} else {
+		std::cout << "Test 22 FAIL" << std::endl;
+	}
 }
 
+void format_test3(){
+	// JSON Feed, escaped strings are decoded, unknown values are skipped
+	std::string feed = "{\"version\":\"https://jsonfeed.org/version/1.1\",\"title\":\"J\\\"S\\u00e9\\ud83d\\ude00\","
+		"\"skip\":{\"a\":[1,-2.5e3,true,null,\"]}\"]},\"items\":[{\"id\":7,\"title\":\"One\",\"url\":\"http://a/1\","
+		"\"date_published\":\"2025\",\"date_modified\":\"2026\",\"authors\":[{\"name\":\"Ann\"},{\"name\":\"Bob\"}]},"
+		"{\"title\":\"Two\",\"external_url\":\"http://b/2\",\"author\":{\"name\":\"Old\"}},{\"content_text\":\"x\"}]}";
+	std::ostringstream out, bad;
+	Parser(feed, true, true, true, out).parse_feed();
+	Parser("{\"title\":\"x\",\"items\":[{\"title\":\"y\"},]}", false, false, false, bad).parse_feed();
+	if (out.str() == "*** J\"S\xc3\xa9\xf0\x9f\x98\x80 ***\nOne\nAktualizace: 2026\nAutor: Ann\nURL: http://a/1\n\n"
+			"Two\nAutor: Old\nURL: http://b/2\n" && bad.str().empty()){
+		std::cout << "Test 23 OK" << std::endl;
+	} else {
+		std::cout << "Test 23 FAIL" << std::endl;
+	}
+}
+
+void feedlist_test1(){
+	// comments, empty lines, invalid and repeated urls are dropped, order of lines is kept
+	char path[] = "/tmp/feedlist_testXXXXXX";
+	int fd = mkstemp(path);
+	std::string content = "# list\nhttp://a/1\r\n\nftp://b/2\nhttps://c/3\nhttp://a/1\n#http://d/4\nhttp://e/5";
+	write(fd, content.data(), content.size());
+	close(fd);
+
+	FeedList list, parallel, empty;
+	bool loaded = list.load(path, 1) && parallel.load(path, 4);
+	unlink(path);
+	std::vector<std::string_view> expected = {"http://a/1", "https://c/3", "http://e/5"};
+	if (loaded && list.urls() == expected && parallel.urls() == expected && !empty.load("/nonexistent/feedfile")){
+		std::cout << "Test 24 OK" << std::endl;
+	} else {
+		std::cout << "Test 24 FAIL" << std::endl;
+	}
+}
+
+void feedlist_test2(){
+	// pipe has no size, it is read until writer closes it
+	int fds[2];
+	pipe(fds);
+	std::string content = "http://a/1\nhttps://c/3\nhttp://a/1\n";
+	write(fds[1], content.data(), content.size());
+	close(fds[1]);
+
+	FeedList list;
+	bool loaded = list.load("/dev/fd/" + std::to_string(fds[0]));
+	close(fds[0]);
+	std::vector<std::string_view> expected = {"http://a/1", "https://c/3"};
+	if (loaded && list.urls() == expected){
+		std::cout << "Test 28 OK" << std::endl;
+	} else {
+		std::cout << "Test 28 FAIL" << std::endl;
+	}
+}
+
+void scheduler_test1(){
+	// lowest priority goes first, busy host waits for its request to finish, ties go to host served longest ago
+	std::vector<std::string_view> urls = {"http://a/1", "http://a/2", "http://A:80/3", "http://b/1", "https://b/2"};
+	struct host_limits limits;
+	limits.connections = 1;
+	Scheduler scheduler;
+	scheduler.set_limits(limits);
+	scheduler.start(urls, {5, 0, 1, 3, 3}, 0);
+
+	std::vector<size_t> order;
+	size_t idx;
+	for (int i = 0; i < 3 && scheduler.take(idx); i++)
+		order.push_back(idx);
+	scheduler.done(1);
+	scheduler.take(idx);
+	order.push_back(idx);
+	scheduler.done(2);
+	scheduler.take(idx);
+	order.push_back(idx);
+	bool finished = !scheduler.take(idx);
+
+	// rate of 20 requests per second with burst 1 starts third request 100 ms after the first one
+	limits.connections = 0;
+	limits.rate = 20;
+	limits.burst = 1;
+	scheduler.set_limits(limits);
+	scheduler.start({"http://c/1", "http://c/2", "http://c/3"}, {}, 0);
+	auto start = std::chrono::steady_clock::now();
+	while (scheduler.take(idx))
+		scheduler.done(idx);
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	std::vector<size_t> expected = {1, 3, 4, 2, 0};
+	if (order == expected && finished && elapsed.count() >= 0.09 && Scheduler::authority("https://Example.COM/feed") == "example.com:443"){
+		std::cout << "Test 25 OK" << std::endl;
+	} else {
+		std::cout << "Test 25 FAIL" << std::endl;
+	}
+}
+
+void poll_test1(){
+	// timestamps of RSS and Atom in different zones denote the same moment
+	bool times = PollStore::parse_time("Sat, 17 Oct 2026 10:30:00 +0200") == 1792225800
+		&& PollStore::parse_time("2026-10-17T08:30:00Z") == 1792225800
+		&& PollStore::parse_time("2026-10-17T03:30:00.123-05:00") == 1792225800
+		&& PollStore::parse_time("17 Oct 2026 04:30 EDT") == 1792225800
+		&& PollStore::parse_time("2026-10-17") == 1792195200
+		&& !PollStore::parse_time("yesterday") && !PollStore::parse_time("2026-13-01");
+
+	// feed parsed first time gets interval from gaps of its entries, two hours here
+	PollStore poll;
+	std::string feed = "<rss><channel><title>T</title>"
+		"<item><title>a</title><pubDate>Sat, 17 Oct 2026 08:00:00 GMT</pubDate></item>"
+		"<item><title>b</title><pubDate>Sat, 17 Oct 2026 06:00:00 GMT</pubDate></item>"
+		"<item><title>c</title><pubDate>Sat, 17 Oct 2026 04:00:00 GMT</pubDate></item>"
+		"</channel></rss>";
+	std::ostringstream out;
+	time_t now = time(nullptr);
+	Parser parser = Parser(feed, false, false, false, out);
+	parser.set_poll_store(&poll, "http://a/feed");
+	parser.parse_feed();
+	bool learned = !poll.due("http://a/feed", now + 7000) && poll.due("http://a/feed", now + 7300) && poll.due("http://b/feed", now);
+
+	// unchanged feed backs off, history survives save and load
+	struct poll_sample same;
+	PollStore::observe(same, "a", "");
+	PollStore::observe(same, "b", "");
+	PollStore::observe(same, "c", "");
+	poll.update("http://a/feed", same, now);
+	char path[] = "/tmp/poll_testXXXXXX";
+	close(mkstemp(path));
+	PollStore loaded;
+	bool stored = poll.save(path) && loaded.load(path);
+	unlink(path);
+	bool backoff = !loaded.due("http://a/feed", now + 10700) && loaded.due("http://a/feed", now + 10900);
+
+	// feed without timestamps changing on every check is checked more and more often
+	bool faster = true;
+	time_t checked = now;
+	time_t interval = POLL_DEFAULT;
+	for (int i = 0; i < 6; i++){
+		struct poll_sample changed;
+		PollStore::observe(changed, std::to_string(i), "");
+		poll.update("http://c/feed", changed, checked);
+		time_t next = poll.due_time("http://c/feed") - checked;
+		faster = faster && (i == 0 ? next == POLL_DEFAULT : next < interval);
+		interval = next;
+		checked += next;
+	}
+	faster = faster && interval < POLL_DEFAULT / 2;
+
+	if (times && learned && stored && backoff && faster){
+		std::cout << "Test 26 OK" << std::endl;
+	} else {
+		std::cout << "Test 26 FAIL" << std::endl;
+	}
+}
+
+void daemon_test1(){
+	// entries of parsed feeds are answered from index, newest of all feeds first
+	Fetcher fetcher = Fetcher("", "", 1);
+	PollStore poll;
+	JsonSink sink;
+	Daemon daemon = Daemon(fetcher, poll, sink, "/tmp/daemon_test.sock");
+	bool updated = daemon.update("http://a/feed", "<rss><channel><title>A</title>"
+		"<item><title>a1</title><pubDate>Sat, 17 Oct 2026 08:00:00 GMT</pubDate></item>"
+		"<item><title>a2</title><pubDate>Sat, 17 Oct 2026 06:00:00 GMT</pubDate></item></channel></rss>")
+		&& daemon.update("http://b/feed", "<feed><title>B</title><entry><title>b1</title>"
+		"<updated>2026-10-17T07:00:00Z</updated></entry></feed>");
+	// feed which can not be read keeps its previous entries
+	bool broken = !daemon.update("http://b/feed", "<feed><title>B</ti");
+
+	std::ostringstream latest, entries, feeds, status, error;
+	daemon.handle("LATEST 2", latest);
+	daemon.handle("ENTRIES http://b/feed", entries);
+	daemon.handle("FEEDS", feeds);
+	daemon.handle("STATUS", status);
+	daemon.handle("ENTRIES http://c/feed", error);
+	daemon.handle("DELETE", error);
+
+	if (updated && broken
+		&& latest.str().find("\"title\":\"a1\"") < latest.str().find("\"title\":\"b1\"")
+		&& latest.str().find("a2") == std::string::npos
+		&& entries.str().find("\"feed_title\":\"B\"") != std::string::npos
+		&& feeds.str().find("http://a/feed\t") == 0 && feeds.str().find("\t2\tA\n") != std::string::npos
+		&& status.str() == "rounds 0 feeds 2 entries 3\n"
+		&& error.str() == "ERROR unknown feed\nERROR unknown request\n"
+		&& !poll.due("http://a/feed", time(nullptr))){
+		std::cout << "Test 27 OK" << std::endl;
+	} else {
+		std::cout << "Test 27 FAIL" << std::endl;
+	}
+}
+
+void daemon_test2(){
+	// feed never read successfully is retried after shortest round even if other feeds are not due
+	Fetcher fetcher = Fetcher("", "", 1);
+	PollStore poll;
+	JsonSink sink;
+	Daemon daemon = Daemon(fetcher, poll, sink, "/tmp/daemon_test.sock");
+	time_t now = time(nullptr);
+	struct poll_sample sample;
+	PollStore::observe(sample, "id", "");
+	poll.update("http://known/feed", sample, now);
+	time_t both = daemon.next_round({"http://unknown/feed", "http://known/feed"}, now);
+	time_t known = daemon.next_round({"http://known/feed"}, now);
+	if (both == now + DAEMON_ROUND && known == poll.due_time("http://known/feed") && known > both){
+		std::cout << "Test 38 OK" << std::endl;
+	} else {
+		std::cout << "Test 38 FAIL" << std::endl;
+	}
+}
 
 int main(){
 	test_arguments();
+	test_buffer();
+	test_http();
+	test_decoder();
+	test_url();
+	test_resolver();
+	test_seen();
+	test_cache();
+	session_test1();
+	keepalive_test1();
+	test_sink();
+	output_test1();
+	pipeline_test1();
+	parser_test1();
+	parser_test2();
+	parser_test3();
+	stream_test1();
+	format_test1();
+	format_test2();
+	format_test3();
+	feedlist_test1();
+	feedlist_test2();
+	scheduler_test1();
+	poll_test1();
+	daemon_test1();
+	daemon_test2();
 
+	xmlCleanupParser();
 	return 0;
 }
 